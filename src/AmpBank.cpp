@@ -0,0 +1,309 @@
+#include "AmpBank.h"
+
+//==============================================================================
+AmpBank::AmpBank (int numInstancesToUse)
+    : numInstances (numInstancesToUse)
+{
+    jassert (numInstances > 0);
+
+    auto size = static_cast<size_t> (numInstances);
+
+    settings.resize (size);
+
+    driveSmoothed.resize (size);
+    bassSmoothed.resize (size);
+    midSmoothed.resize (size);
+    trebleSmoothed.resize (size);
+    presenceSmoothed.resize (size);
+    masterSmoothed.resize (size);
+
+    staleControls.resize (size);
+
+    for (int first = 0; first < numInstances; first += numLanes)
+    {
+        auto group = std::make_unique<Group>();
+        group->firstInstance = first;
+        group->numInstances = juce::jmin (numLanes, numInstances - first);
+
+        PlexiVoicing::initialiseTubeStages (group->chain);
+        groups.push_back (std::move (group));
+    }
+}
+
+void AmpBank::prepare (double sampleRate, int maximumBlockSize, int oversampling, bool linearPhase)
+{
+    // One oversampler channel per instance; JUCE filters each channel on its own
+    auto quality = OversamplingQuality::getQuality (oversampling, sampleRate);
+
+    oversampler = std::make_unique<juce::dsp::Oversampling<float>> (
+        static_cast<size_t> (numInstances),
+        quality.oversamplingStages,
+        linearPhase ? juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                    : juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+        true,  // Max quality
+        true   // Integer latency
+    );
+    oversampler->initProcessing (static_cast<size_t> (maximumBlockSize));
+
+    auto oversamplingFactor = static_cast<int> (oversampler->getOversamplingFactor());
+    auto oversampledRate = sampleRate * oversamplingFactor;
+    antiderivativeLatency = quality.antiderivative ? PlexiVoicing::antiderivativeDelaySamples / oversamplingFactor : 0;
+
+    juce::dsp::ProcessSpec laneSpec;
+    laneSpec.sampleRate = oversampledRate;
+    laneSpec.maximumBlockSize = static_cast<juce::uint32> (maximumBlockSize * oversamplingFactor);
+    laneSpec.numChannels = 1;
+
+    // Emphasis filters are the same for every instance; the tone stack and
+    // presence use per-lane coefficients (their shared pointers stay null)
+    preEmphasisCoefficients = PlexiVoicing::makePreEmphasis (oversampledRate);
+    deEmphasisCoefficients = PlexiVoicing::makeDeEmphasis (oversampledRate);
+    toneStackModel.prepare (oversampledRate);
+
+    for (auto& group : groups)
+    {
+        group->chain.get<2>().coefficients = preEmphasisCoefficients;
+        group->chain.get<8>().coefficients = deEmphasisCoefficients;
+
+        group->chain.prepare (laneSpec);
+        PlexiVoicing::configureFixedStages (group->chain);
+        PlexiVoicing::setAntiderivativeTubes (group->chain, quality.antiderivative);
+
+        group->lanes = juce::dsp::AudioBlock<VectorSample> (group->data, 1, laneSpec.maximumBlockSize);
+        group->lanes.clear();  // Lanes beyond the group's instances stay silent
+    }
+
+    // Smoothers start settled on the current settings (chain.prepare() settles the supply)
+    for (size_t i = 0; i < settings.size(); ++i)
+    {
+        auto& s = settings[i];
+
+        for (auto* smoother : { &driveSmoothed[i], &bassSmoothed[i], &midSmoothed[i],
+                                &trebleSmoothed[i], &presenceSmoothed[i], &masterSmoothed[i] })
+            smoother->reset (sampleRate, PlexiVoicing::smoothingSeconds);
+
+        driveSmoothed[i].setCurrentAndTargetValue (s.drive);
+        bassSmoothed[i].setCurrentAndTargetValue (s.bass);
+        midSmoothed[i].setCurrentAndTargetValue (s.mid);
+        trebleSmoothed[i].setCurrentAndTargetValue (s.treble);
+        presenceSmoothed[i].setCurrentAndTargetValue (s.presence);
+        masterSmoothed[i].setCurrentAndTargetValue (s.master);
+
+        // chain.prepare() set the channel filter of every lane to the same
+        // cutoff, and the other stages have nothing for this rate yet
+        staleControls[i] = allFlags;
+    }
+
+    // Cabinets: the IR is partitioned and fitted here once, and every
+    // instance's convolution shares those partitions
+    auto ir = CabinetConvolution::createBuiltInImpulseResponse (sampleRate);
+    cabinetImpulseResponse.setImpulseResponse (ir.getReadPointer (0), ir.getNumSamples());
+
+    CabinetLiteModel liteModel;
+    liteModel.fit (ir.getReadPointer (0), ir.getNumSamples(), sampleRate);
+
+    while (cabinets.size() < settings.size())
+        cabinets.push_back (std::make_unique<Cabinet>());
+
+    for (auto& cabinet : cabinets)
+    {
+        cabinet->convolution.shareImpulseResponse (cabinetImpulseResponse);
+        cabinet->liteModel = liteModel;
+    }
+}
+
+void AmpBank::setSettings (int instance, const Settings& newSettings) noexcept
+{
+    jassert (juce::isPositiveAndBelow (instance, numInstances));
+
+    auto i = static_cast<size_t> (instance);
+    auto& s = settings[i];
+    auto& stale = staleControls[i];
+
+    if (newSettings.channel != s.channel || newSettings.link != s.link)  stale |= channelFlag;
+    if (newSettings.drive != s.drive)                                     stale |= driveFlag;
+    if (newSettings.bass != s.bass || newSettings.mid != s.mid
+         || newSettings.treble != s.treble)                               stale |= toneStackFlag;
+    if (newSettings.presence != s.presence)                               stale |= presenceFlag;
+    if (newSettings.master != s.master)                                   stale |= masterFlag;
+
+    s = newSettings;
+}
+
+int AmpBank::getLatencySamples() const noexcept
+{
+    jassert (oversampler != nullptr);
+    return static_cast<int> (oversampler->getLatencyInSamples()) + antiderivativeLatency;
+}
+
+//==============================================================================
+void AmpBank::process (float* const* channels, int numSamples) noexcept
+{
+    juce::ScopedNoDenormals noDenormals;
+    jassert (oversampler != nullptr);
+
+    // Per-instance control state, in the order ClaudeAmpProcessor::processBlock does it
+    for (size_t i = 0; i < settings.size(); ++i)
+    {
+        auto& s = settings[i];
+
+        driveSmoothed[i].setTargetValue (s.drive);
+        bassSmoothed[i].setTargetValue (s.bass);
+        midSmoothed[i].setTargetValue (s.mid);
+        trebleSmoothed[i].setTargetValue (s.treble);
+        presenceSmoothed[i].setTargetValue (s.presence);
+        masterSmoothed[i].setTargetValue (s.master);
+    }
+
+    juce::dsp::AudioBlock<float> block (channels, static_cast<size_t> (numInstances), static_cast<size_t> (numSamples));
+    auto oversampledBlock = oversampler->processSamplesUp (block);
+
+    for (auto& group : groups)
+    {
+        auto instances = oversampledBlock.getSubsetChannelBlock (static_cast<size_t> (group->firstInstance),
+                                                                 static_cast<size_t> (group->numInstances));
+        auto lanes = group->lanes.getSubBlock (0, oversampledBlock.getNumSamples());
+
+        PlexiStages::interleave (instances, lanes);
+        processGroup (*group, lanes, numSamples);
+        PlexiStages::deinterleave (lanes, instances);
+    }
+
+    oversampler->processSamplesDown (block);
+
+    for (size_t i = 0; i < settings.size(); ++i)
+    {
+        auto mode = settings[i].cabinet;
+
+        if (mode == 0)
+            continue;
+
+        auto& cabinet = *cabinets[i];
+        auto* data = block.getChannelPointer (i);
+
+        // As in CabinetConvolution, the model switched to starts from silence
+        if (mode != cabinet.mode)
+        {
+            if (mode == 1)
+                cabinet.liteModel.reset();
+            else
+                cabinet.convolution.reset();
+
+            cabinet.mode = mode;
+        }
+
+        if (mode == 1)
+            cabinet.liteModel.process (data, numSamples);
+        else
+            cabinet.convolution.process (data, data, numSamples);
+    }
+}
+
+void AmpBank::processGroup (Group& group, juce::dsp::AudioBlock<VectorSample> block, int numSamples) noexcept
+{
+    auto first = static_cast<size_t> (group.firstInstance);
+    auto isRamping = false;
+
+    for (size_t lane = 0; lane < static_cast<size_t> (group.numInstances); ++lane)
+    {
+        auto i = first + lane;
+
+        // Same channel filter as the processor's variant for this voicing
+        if ((staleControls[i] & channelFlag) != 0)
+        {
+            auto channelFilter = PlexiVoicing::getChannelFilter (PlexiVoicing::getVoicing (settings[i].channel, settings[i].link));
+            group.chain.get<1>().setParameters (lane, channelFilter.cutoffHz, channelFilter.resonance);
+            staleControls[i] &= ~static_cast<juce::uint32> (channelFlag);
+        }
+
+        isRamping = isRamping || driveSmoothed[i].isSmoothing() || bassSmoothed[i].isSmoothing()
+                              || midSmoothed[i].isSmoothing() || trebleSmoothed[i].isSmoothing()
+                              || presenceSmoothed[i].isSmoothing() || masterSmoothed[i].isSmoothing();
+    }
+
+    if (! isRamping)
+    {
+        updateSmoothedLanes (group);
+
+        juce::dsp::ProcessContextReplacing<VectorSample> context (block);
+        PlexiVoicing::process (group.chain, context);
+        return;
+    }
+
+    // Same chunking as the processor. Settled lanes keep their coefficients
+    auto factor = oversampler->getOversamplingFactor();
+
+    for (int start = 0; start < numSamples; start += PlexiVoicing::smoothingChunkSize)
+    {
+        auto chunkSize = juce::jmin (PlexiVoicing::smoothingChunkSize, numSamples - start);
+
+        for (auto i = first; i < first + static_cast<size_t> (group.numInstances); ++i)
+        {
+            driveSmoothed[i].skip (chunkSize);
+            bassSmoothed[i].skip (chunkSize);
+            midSmoothed[i].skip (chunkSize);
+            trebleSmoothed[i].skip (chunkSize);
+            presenceSmoothed[i].skip (chunkSize);
+            masterSmoothed[i].skip (chunkSize);
+        }
+
+        updateSmoothedLanes (group);
+
+        auto chunkBlock = block.getSubBlock (static_cast<size_t> (start) * factor,
+                                             static_cast<size_t> (chunkSize) * factor);
+        juce::dsp::ProcessContextReplacing<VectorSample> context (chunkBlock);
+        PlexiVoicing::process (group.chain, context);
+    }
+}
+
+void AmpBank::updateSmoothedLanes (Group& group) noexcept
+{
+    auto& chain = group.chain;
+
+    for (size_t lane = 0; lane < static_cast<size_t> (group.numInstances); ++lane)
+    {
+        auto i = static_cast<size_t> (group.firstInstance) + lane;
+        auto& stale = staleControls[i];
+
+        if ((stale & ~static_cast<juce::uint32> (channelFlag)) == 0)
+            continue;
+
+        // Same rule as ClaudeAmpProcessor::updateDerivedControls()
+        auto update = [&stale] (juce::uint32 flags, bool smoothing, auto&& recompute)
+        {
+            if ((stale & flags) == 0)
+                return;
+
+            recompute();
+
+            if (! smoothing)
+                stale &= ~flags;
+        };
+
+        update (driveFlag, driveSmoothed[i].isSmoothing(), [&]
+        {
+            chain.get<0>().setGainDecibels (lane, PlexiVoicing::getInputGainDecibels (driveSmoothed[i].getCurrentValue()));
+        });
+
+        update (toneStackFlag,
+                bassSmoothed[i].isSmoothing() || midSmoothed[i].isSmoothing() || trebleSmoothed[i].isSmoothing(), [&]
+        {
+            float toneStack[ToneStackModel::coefficientsPerToneStack];
+            toneStackModel.getToneStack (bassSmoothed[i].getCurrentValue(), midSmoothed[i].getCurrentValue(),
+                                         trebleSmoothed[i].getCurrentValue(), toneStack);
+            chain.get<9>().setCoefficients (lane, toneStack);
+        });
+
+        update (presenceFlag, presenceSmoothed[i].isSmoothing(), [&]
+        {
+            float presence[ToneStackModel::coefficientsPerFilter];
+            toneStackModel.getPresence (presenceSmoothed[i].getCurrentValue(), presence);
+            chain.get<11>().setCoefficients (lane, presence);
+        });
+
+        update (masterFlag, masterSmoothed[i].isSmoothing(), [&]
+        {
+            chain.get<13>().setGainDecibels (lane, PlexiVoicing::getMasterGainDecibels (masterSmoothed[i].getCurrentValue()));
+        });
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "CabinetConvolution.h"
+#include "OversamplingQuality.h"
+#include "PlexiChain.h"
+#include "ToneStackModel.h"
+
+//==============================================================================
+/**
+    Many mono ClaudeAmp instances advanced in lockstep, for server-side rendering.
+
+    A bank keeps its amps in struct-of-arrays form. Instances are packed into
+    the SIMD lanes of PlexiChain<SIMDRegister<float>> groups, so one register
+    holds the same filter state (or coefficient) of several instances and
+    every vector operation advances all of them. Per-instance settings become
+    per-lane gains, channel filters and tone stack coefficients (the sag
+    follower already runs per lane in the power stage); smoothers are plain
+    arrays. One multichannel oversampler, one tone stack model (with its
+    presence table) and one set of cabinet IR partitions and lite fit replace
+    the per-instance copies N separate processors would carry; the tube
+    tables are shared process-wide anyway.
+
+    Each instance produces the same samples as a mono-in ClaudeAmpProcessor
+    with the same settings, fed the same blocks. This relies on scalar and
+    SIMD arithmetic rounding alike, which is why CMake builds the files that
+    compile the chain's stages with -ffp-contract=off. Every instance uses the built-in cabinet IR. Lanes
+    share one generic chain, so channel/link and cabinet changes switch
+    directly where the processor crossfades between its chain variants.
+    The bank never skips silence: where the processor bypasses a long silent
+    stretch, the bank keeps processing it, so their outputs match up to float
+    rounding there rather than exactly.
+*/
+class AmpBank
+{
+public:
+    //==============================================================================
+    /** Control settings of one instance, in parameter units. */
+    struct Settings
+    {
+        int channel = 0;      // 0=Normal, 1=Bright
+        bool link = false;
+        float drive = 5.0f;
+        float bass = 5.0f;
+        float mid = 5.0f;
+        float treble = 5.0f;
+        float presence = 5.0f;
+        float master = 5.0f;
+        int cabinet = 2;      // 0=Off, 1=Lite, 2=Full
+    };
+
+    explicit AmpBank (int numInstances);
+
+    int getNumInstances() const noexcept    { return numInstances; }
+
+    /** Prepares every instance. oversampling uses the parameter's choices
+        (0 = Auto, 1 = 1x ... 4 = 8x, 5/6 = 1x/2x ADAA). Not realtime safe.
+    */
+    void prepare (double sampleRate, int maximumBlockSize, int oversampling = 0, bool linearPhase = false);
+
+    /** Changes an instance's settings. Like parameter changes on a processor,
+        they are picked up by the next process() call and smoothed from there;
+        only the lanes and stages whose settings changed are recomputed.
+    */
+    void setSettings (int instance, const Settings& newSettings) noexcept;
+
+    /** Processes one mono block per instance, in place. */
+    void process (float* const* channels, int numSamples) noexcept;
+
+    /** Latency of every instance (oversampling and ADAA; the cabinet adds none). */
+    int getLatencySamples() const noexcept;
+
+private:
+    //==============================================================================
+    using VectorSample = juce::dsp::SIMDRegister<float>;
+    static constexpr int numLanes = static_cast<int> (VectorSample::size());
+
+    struct Group
+    {
+        PlexiChain<VectorSample> chain;
+        juce::HeapBlock<char> data;
+        juce::dsp::AudioBlock<VectorSample> lanes;
+        int firstInstance = 0, numInstances = 0;
+    };
+
+    void processGroup (Group& group, juce::dsp::AudioBlock<VectorSample> block, int numSamples) noexcept;
+    void updateSmoothedLanes (Group& group) noexcept;
+
+    //==============================================================================
+    const int numInstances;
+    std::vector<std::unique_ptr<Group>> groups;
+
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampler;
+    int antiderivativeLatency = 0;  // Host samples the ADAA tube stages add
+    ToneStackModel toneStackModel;
+    juce::dsp::IIR::Coefficients<float>::Ptr preEmphasisCoefficients, deEmphasisCoefficients;
+
+    // Per instance (struct of arrays)
+    std::vector<Settings> settings;
+    std::vector<juce::SmoothedValue<float>> driveSmoothed, bassSmoothed, midSmoothed,
+                                            trebleSmoothed, presenceSmoothed, masterSmoothed;
+
+    // What each lane's stages are derived from, recomputed only while stale,
+    // as in ClaudeAmpProcessor: a setting that changes marks its stages, and
+    // they stay stale until its smoother has landed and the final value is set
+    enum StaleFlags : juce::uint32
+    {
+        channelFlag   = 1 << 0,  // Stage 1, from channel and link
+        driveFlag     = 1 << 1,  // Stage 0
+        toneStackFlag = 1 << 2,  // Stage 9, from bass, mid and treble
+        presenceFlag  = 1 << 3,  // Stage 11
+        masterFlag    = 1 << 4,  // Stage 13
+
+        allFlags = channelFlag | driveFlag | toneStackFlag | presenceFlag | masterFlag
+    };
+
+    std::vector<juce::uint32> staleControls;
+
+    // Cabinets (built-in IR): the partitions are built and the lite model
+    // fitted once per bank; each instance keeps only its own filter state
+    struct Cabinet
+    {
+        PartitionedConvolution convolution;
+        CabinetLiteModel liteModel;
+        int mode = 2;  // Model that ran last (1=Lite, 2=Full)
+    };
+
+    PartitionedConvolution cabinetImpulseResponse;
+    std::vector<std::unique_ptr<Cabinet>> cabinets;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AmpBank)
+};
@@ -0,0 +1,162 @@
+#include "AmpMeters.h"
+
+//==============================================================================
+AmpMeters::AmpMeters (AmpTelemetry& t)
+    : telemetry (t)
+{
+    setOpaque (true);
+
+    // Frames left over from an earlier editor are stale
+    while (telemetry.pop (frames, AmpTelemetry::fifoSize) > 0) {}
+
+    telemetry.setEnabled (true);
+    startTimerHz (refreshRateHz);
+}
+
+AmpMeters::~AmpMeters()
+{
+    telemetry.setEnabled (false);
+}
+
+void AmpMeters::resized()
+{
+    auto area = getLocalBounds().reduced (10, 4);
+    auto cellWidth = area.getWidth() / numMeters;
+
+    for (int i = 0; i < numMeters; ++i)
+        meterBounds[i] = i < numMeters - 1 ? area.removeFromLeft (cellWidth) : area;
+
+    // Redraw everything at the new size on the next refresh
+    for (auto& display : displays)
+        display = {};
+
+    repaint();
+}
+
+juce::Rectangle<int> AmpMeters::getBarBounds (int meter) const
+{
+    return meterBounds[meter].withTrimmedLeft (34).reduced (4, 0).removeFromBottom (8);
+}
+
+//==============================================================================
+void AmpMeters::timerCallback()
+{
+    auto numFrames = telemetry.pop (frames, AmpTelemetry::fifoSize);
+
+    // Meters fall at a fixed rate and rise straight to anything louder
+    auto fall = fallDecibelsPerSecond / static_cast<float> (refreshRateHz);
+    auto toDecibels = [] (float gain) { return juce::Decibels::gainToDecibels (gain, minimumDecibels); };
+
+    float levels[2][2] {};   // [input/output][peak/rms]
+    int clipped[PlexiVoicing::numTubeStages] {};
+    int stageSamples = 0;
+
+    for (int f = 0; f < numFrames; ++f)
+    {
+        auto& frame = frames[f];
+
+        levels[0][0] = juce::jmax (levels[0][0], frame.inputPeak);
+        levels[0][1] = juce::jmax (levels[0][1], frame.inputRms);
+        levels[1][0] = juce::jmax (levels[1][0], frame.outputPeak);
+        levels[1][1] = juce::jmax (levels[1][1], frame.outputRms);
+
+        for (int i = 0; i < PlexiVoicing::numTubeStages; ++i)
+            clipped[i] += frame.clippedSamples[i];
+
+        stageSamples += frame.stageSamples;
+    }
+
+    for (int i = 0; i < 2; ++i)
+    {
+        peakDecibels[i] = juce::jmax (toDecibels (levels[i][0]), peakDecibels[i] - fall);
+        rmsDecibels[i] = juce::jmax (toDecibels (levels[i][1]), rmsDecibels[i] - fall);
+    }
+
+    // Sag and clipping hold their last reading while frames arrive and fall away when they stop
+    if (numFrames > 0)
+        sagDecibels = frames[numFrames - 1].sagDecibels;
+    else
+        sagDecibels = juce::jmax (0.0f, sagDecibels - fall * 0.1f);
+
+    for (int i = 0; i < PlexiVoicing::numTubeStages; ++i)
+    {
+        if (stageSamples > 0)
+            clippedFraction[i] = static_cast<float> (clipped[i]) / static_cast<float> (stageSamples);
+        else
+            clippedFraction[i] *= 0.7f;
+    }
+
+    //==============================================================================
+    auto levelProportion = [] (float decibels) { return (decibels - minimumDecibels) / -minimumDecibels; };
+
+    auto makeDisplay = [this] (int meter, float barProportion, float markerProportion, bool hot, juce::String text)
+    {
+        auto bar = getBarBounds (meter);
+        auto width = static_cast<float> (bar.getWidth());
+
+        Display display;
+        display.barWidth = juce::roundToInt (width * juce::jlimit (0.0f, 1.0f, barProportion));
+        display.markerX = markerProportion > 0.0f ? juce::roundToInt (width * juce::jmin (1.0f, markerProportion)) : -1;
+        display.hot = hot;
+        display.text = std::move (text);
+        return display;
+    };
+
+    Display next[numMeters];
+
+    for (int i = 0; i < 2; ++i)
+        next[input + i] = makeDisplay (input + i, levelProportion (rmsDecibels[i]), levelProportion (peakDecibels[i]),
+                                       peakDecibels[i] > -0.1f,
+                                       peakDecibels[i] > minimumDecibels ? juce::String (peakDecibels[i], 1) : juce::String ("-inf"));
+
+    next[sag] = makeDisplay (sag, sagDecibels / 3.2f, 0.0f, false, juce::String (sagDecibels, 1) + " dB");
+
+    for (int i = 0; i < PlexiVoicing::numTubeStages; ++i)
+        next[preamp1 + i] = makeDisplay (preamp1 + i, clippedFraction[i], 0.0f, clippedFraction[i] > 0.01f,
+                                         juce::String (juce::roundToInt (clippedFraction[i] * 100.0f)) + "%");
+
+    // Only meters whose picture changed are redrawn, each within its own bounds
+    for (int i = 0; i < numMeters; ++i)
+    {
+        if (next[i] == displays[i])
+            continue;
+
+        displays[i] = next[i];
+        repaint (meterBounds[i]);
+    }
+}
+
+void AmpMeters::paint (juce::Graphics& g)
+{
+    static const char* const names[numMeters] { "IN", "OUT", "SAG", "V1", "V2", "V3", "EL34" };
+    auto marshallGold = juce::Colour (0xffd4af37);
+
+    g.fillAll (juce::Colours::black);
+    g.setFont (juce::Font (12.0f));
+
+    auto clip = g.getClipBounds();
+
+    for (int i = 0; i < numMeters; ++i)
+    {
+        if (! meterBounds[i].intersects (clip))
+            continue;
+
+        auto& display = displays[i];
+        auto cell = meterBounds[i];
+        auto bar = getBarBounds (i);
+        auto colour = display.hot ? juce::Colours::red : marshallGold;
+
+        g.setColour (marshallGold);
+        g.drawText (names[i], cell.removeFromLeft (34), juce::Justification::centredLeft, false);
+        g.drawText (display.text, cell.withTrimmedBottom (bar.getHeight()).reduced (4, 0), juce::Justification::centredRight, false);
+
+        g.setColour (juce::Colours::darkgrey);
+        g.fillRect (bar);
+
+        g.setColour (colour);
+        g.fillRect (bar.withWidth (display.barWidth));
+
+        if (display.markerX >= 0)
+            g.fillRect (bar.getX() + juce::jmin (display.markerX, bar.getWidth() - 2), bar.getY(), 2, bar.getHeight());
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AmpTelemetry.h"
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+//==============================================================================
+/**
+    Meter strip fed by AmpTelemetry: input and output level (RMS bar, peak
+    marker), power supply sag, and the share of samples each tube stage clips.
+
+    Telemetry is enabled for as long as the strip exists. A timer drains the
+    frames, and each meter repaints its own bounds only when what it shows
+    moves by a pixel or changes its text, so idle or steady meters cost
+    nothing and many open editors stay cheap.
+*/
+class AmpMeters final : public juce::Component,
+                        private juce::Timer
+{
+public:
+    explicit AmpMeters (AmpTelemetry&);
+    ~AmpMeters() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    static constexpr int preferredHeight = 30;
+
+private:
+    void timerCallback() override;
+
+    enum Meter
+    {
+        input,
+        output,
+        sag,
+        preamp1,
+        preamp2,
+        preamp3,
+        powerAmp,
+        numMeters
+    };
+
+    static constexpr int refreshRateHz = 30;
+    static constexpr float minimumDecibels = -60.0f;
+    static constexpr float fallDecibelsPerSecond = 20.0f;
+
+    // What a meter shows, in pixels, so a repaint is only asked for when it changes
+    struct Display
+    {
+        int barWidth = 0;
+        int markerX = -1;   // None when negative
+        bool hot = false;   // Drawn in red (peaks at 0 dBFS, clipping above 1%)
+        juce::String text;
+
+        bool operator== (const Display& other) const noexcept
+        {
+            return barWidth == other.barWidth && markerX == other.markerX && hot == other.hot && text == other.text;
+        }
+    };
+
+    AmpTelemetry& telemetry;
+    AmpTelemetry::Frame frames[AmpTelemetry::fifoSize];
+
+    // Meter ballistics: levels in dB, sag in dB, clipping as a fraction of samples
+    float rmsDecibels[2] { minimumDecibels, minimumDecibels };
+    float peakDecibels[2] { minimumDecibels, minimumDecibels };
+    float sagDecibels = 0.0f;
+    float clippedFraction[PlexiVoicing::numTubeStages] {};
+
+    juce::Rectangle<int> meterBounds[numMeters];
+    Display displays[numMeters];
+
+    juce::Rectangle<int> getBarBounds (int meter) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AmpMeters)
+};
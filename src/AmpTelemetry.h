@@ -0,0 +1,150 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "PlexiChain.h"
+
+//==============================================================================
+/**
+    Decimated amp telemetry for meters: levels in and out, power supply sag and
+    how often each tube stage clips.
+
+    The audio thread adds up every block and publishes one Frame every
+    1/framesPerSecond seconds through a wait-free single-producer,
+    single-consumer FIFO (juce::AbstractFifo over preallocated frames), so it
+    never allocates or locks. When the FIFO is full the new frame is dropped.
+    A single consumer, the editor, enables the telemetry and pops frames on a
+    timer; while it is disabled the audio thread measures nothing.
+*/
+class AmpTelemetry
+{
+public:
+    //==============================================================================
+    static constexpr double framesPerSecond = 30.0;
+    static constexpr int fifoSize = 32;  // About a second of frames
+
+    struct Frame
+    {
+        float inputPeak = 0.0f, inputRms = 0.0f;    // Linear, over the amp's input channels
+        float outputPeak = 0.0f, outputRms = 0.0f;  // Linear, over the output channels
+        float sagDecibels = 0.0f;                   // Headroom taken by power supply sag at the frame's end
+
+        // Samples past each tube stage's clip points (preamp 1-3, then the power
+        // amp) out of stageSamples, both counted at the oversampled rate over
+        // the channels the amp ran
+        int clippedSamples[PlexiVoicing::numTubeStages] {};
+        int stageSamples = 0;
+    };
+
+    //==============================================================================
+    /** Consumer: starts or stops the measurements. */
+    void setEnabled (bool shouldBeEnabled) noexcept   { enabled.store (shouldBeEnabled, std::memory_order_release); }
+    bool isEnabled() const noexcept                   { return enabled.load (std::memory_order_acquire); }
+
+    /** Consumer: copies out up to maxFrames of the oldest frames and returns how many. */
+    int pop (Frame* destination, int maxFrames) noexcept
+    {
+        const auto scope = fifo.read (juce::jmin (maxFrames, fifo.getNumReady()));
+        scope.forEach ([&] (int index) { *destination++ = frames[index]; });
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    //==============================================================================
+    /** Audio thread (or while it is stopped): sets the frame length and drops
+        anything measured so far.
+    */
+    void prepare (double sampleRate) noexcept
+    {
+        samplesPerFrame = juce::jmax (1, juce::roundToInt (sampleRate / framesPerSecond));
+        clear();
+    }
+
+    /** Audio thread: drops what the current frame has measured so far. */
+    void clear() noexcept
+    {
+        current = {};
+        inputSquares = outputSquares = 0.0;
+        inputValues = outputValues = 0;
+        accumulatedSamples = 0;
+    }
+
+    /** Audio thread: measures a block's input, before it is processed. */
+    void addInput (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+    {
+        measure (buffer, numChannels, numSamples, current.inputPeak, inputSquares, inputValues);
+    }
+
+    /** Audio thread: measures a block's output. */
+    void addOutput (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+    {
+        measure (buffer, numChannels, numSamples, current.outputPeak, outputSquares, outputValues);
+    }
+
+    /** Audio thread: adds a block's tube stage counts and the current sag. */
+    void addStages (const int (&clippedSamples)[PlexiVoicing::numTubeStages], int stageSamples, float sagDecibels) noexcept
+    {
+        for (int i = 0; i < PlexiVoicing::numTubeStages; ++i)
+            current.clippedSamples[i] += clippedSamples[i];
+
+        current.stageSamples += stageSamples;
+        current.sagDecibels = sagDecibels;
+    }
+
+    /** Audio thread: ends a block of numSamples, publishing a frame once a
+        frame's worth has been measured.
+    */
+    void endBlock (int numSamples) noexcept
+    {
+        accumulatedSamples += numSamples;
+
+        if (accumulatedSamples < samplesPerFrame)
+            return;
+
+        current.inputRms = getRms (inputSquares, inputValues);
+        current.outputRms = getRms (outputSquares, outputValues);
+
+        const auto scope = fifo.write (1);
+
+        if (scope.blockSize1 > 0)
+            frames[scope.startIndex1] = current;
+
+        clear();
+    }
+
+private:
+    //==============================================================================
+    static void measure (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples,
+                         float& peak, double& squares, int& numValues) noexcept
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = buffer.getReadPointer (channel);
+            auto range = juce::FloatVectorOperations::findMinAndMax (data, numSamples);
+            auto sum = 0.0f;
+
+            for (int i = 0; i < numSamples; ++i)
+                sum += data[i] * data[i];
+
+            peak = juce::jmax (peak, -range.getStart(), range.getEnd());
+            squares += sum;
+        }
+
+        numValues += numChannels * numSamples;
+    }
+
+    static float getRms (double squares, int numValues) noexcept
+    {
+        return numValues > 0 ? static_cast<float> (std::sqrt (squares / numValues)) : 0.0f;
+    }
+
+    // Shared
+    std::atomic<bool> enabled { false };
+    juce::AbstractFifo fifo { fifoSize };
+    Frame frames[fifoSize];
+
+    // Audio thread only
+    Frame current;
+    double inputSquares = 0.0, outputSquares = 0.0;
+    int inputValues = 0, outputValues = 0;
+    int accumulatedSamples = 0, samplesPerFrame = 1;
+};
@@ -0,0 +1,140 @@
+#include "BinaryState.h"
+
+namespace BinaryState
+{
+    const char* const parameterIDs[numParameters]
+        { "channel", "link", "drive", "bass", "mid", "treble", "presence", "master",
+          "cabinet", "oversampling", "oversamplingFilter" };
+
+    namespace
+    {
+        // Section sizes of layout version 1
+        constexpr int parameterBytes = 4;
+        constexpr int cabinetSize = 16;   // Flags, maximum length (double), path byte count
+
+        void putUint16 (char* destination, int value) noexcept
+        {
+            auto littleEndian = juce::ByteOrder::swapIfBigEndian (static_cast<juce::uint16> (value));
+            std::memcpy (destination, &littleEndian, sizeof (littleEndian));
+        }
+
+        void putUint32 (char* destination, juce::uint32 value) noexcept
+        {
+            value = juce::ByteOrder::swapIfBigEndian (value);
+            std::memcpy (destination, &value, sizeof (value));
+        }
+
+        void putFloat (char* destination, float value) noexcept
+        {
+            juce::uint32 bits;
+            std::memcpy (&bits, &value, sizeof (bits));
+            putUint32 (destination, bits);
+        }
+
+        void putDouble (char* destination, double value) noexcept
+        {
+            juce::uint64 bits;
+            std::memcpy (&bits, &value, sizeof (bits));
+            bits = juce::ByteOrder::swapIfBigEndian (bits);
+            std::memcpy (destination, &bits, sizeof (bits));
+        }
+
+        int getUint16 (const char* source) noexcept
+        {
+            juce::uint16 value;
+            std::memcpy (&value, source, sizeof (value));
+            return juce::ByteOrder::swapIfBigEndian (value);
+        }
+
+        juce::uint32 getUint32 (const char* source) noexcept
+        {
+            juce::uint32 value;
+            std::memcpy (&value, source, sizeof (value));
+            return juce::ByteOrder::swapIfBigEndian (value);
+        }
+
+        float getFloat (const char* source) noexcept
+        {
+            auto bits = getUint32 (source);
+            float value;
+            std::memcpy (&value, &bits, sizeof (value));
+            return value;
+        }
+
+        double getDouble (const char* source) noexcept
+        {
+            juce::uint64 bits;
+            std::memcpy (&bits, source, sizeof (bits));
+            bits = juce::ByteOrder::swapIfBigEndian (bits);
+            double value;
+            std::memcpy (&value, &bits, sizeof (value));
+            return value;
+        }
+    }
+
+    //==============================================================================
+    bool isBinaryState (const void* data, int sizeInBytes) noexcept
+    {
+        return data != nullptr && sizeInBytes >= headerSize
+            && getUint32 (static_cast<const char*> (data)) == magic;
+    }
+
+    void write (const Contents& contents, juce::MemoryBlock& destData)
+    {
+        auto pathBytes = static_cast<int> (contents.cabinetFile.getNumBytesAsUTF8());
+        auto cabinetOffset = headerSize + numParameters * parameterBytes;
+        auto totalSize = cabinetOffset + cabinetSize + pathBytes;
+
+        destData.setSize (static_cast<size_t> (totalSize));
+        auto* destination = static_cast<char*> (destData.getData());
+
+        putUint32 (destination,      magic);
+        putUint16 (destination + 4,  layoutVersion);
+        putUint16 (destination + 6,  contents.stateVersion);
+        putUint16 (destination + 8,  numParameters);
+        putUint16 (destination + 10, 0);  // Reserved
+        putUint32 (destination + 12, static_cast<juce::uint32> (totalSize));
+
+        for (int i = 0; i < numParameters; ++i)
+            putFloat (destination + headerSize + i * parameterBytes, contents.parameters[i]);
+
+        auto* cabinet = destination + cabinetOffset;
+        putUint32 (cabinet,      contents.cabinetMinimumPhase ? 1u : 0u);
+        putDouble (cabinet + 4,  contents.cabinetMaximumLengthSeconds);
+        putUint32 (cabinet + 12, static_cast<juce::uint32> (pathBytes));
+        std::memcpy (cabinet + cabinetSize, contents.cabinetFile.toRawUTF8(), static_cast<size_t> (pathBytes));
+    }
+
+    bool read (const void* data, int sizeInBytes, Contents& contents)
+    {
+        if (! isBinaryState (data, sizeInBytes))
+            return false;
+
+        auto* source = static_cast<const char*> (data);
+        auto totalSize = static_cast<juce::int64> (getUint32 (source + 12));
+        auto storedParameters = getUint16 (source + 8);
+        auto cabinetOffset = headerSize + storedParameters * parameterBytes;
+
+        if (totalSize > sizeInBytes || cabinetOffset + cabinetSize > totalSize)
+            return false;
+
+        contents.stateVersion = getUint16 (source + 6);
+        contents.numStoredParameters = juce::jmin (storedParameters, numParameters);
+
+        for (int i = 0; i < contents.numStoredParameters; ++i)
+            contents.parameters[i] = getFloat (source + headerSize + i * parameterBytes);
+
+        auto* cabinet = source + cabinetOffset;
+        auto pathBytes = static_cast<juce::int64> (getUint32 (cabinet + 12));
+
+        if (cabinetOffset + cabinetSize + pathBytes > totalSize)
+            return false;
+
+        contents.cabinetMinimumPhase = (getUint32 (cabinet) & 1) != 0;
+        contents.cabinetMaximumLengthSeconds = getDouble (cabinet + 4);
+        contents.cabinetFile = juce::String::fromUTF8 (cabinet + cabinetSize, static_cast<int> (pathBytes));
+
+        // Anything after the cabinet belongs to a newer layout
+        return true;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/**
+    Compact binary plugin state, replacing the XML that getStateInformation()
+    used to write.
+
+    The layout is fixed and little-endian:
+
+        Header      magic, layout version, state version, parameter count,
+                    total size (16 bytes)
+        Parameters  one float per parameter in parameterIDs order, in
+                    parameter units
+        Cabinet     flags (bit 0: minimum phase), maximum IR length in
+                    seconds, byte count of the IR path, then the path as UTF-8
+
+    Saving and loading copy each field straight to or from its offset, with
+    nothing to tokenise or look up by name. Later versions only ever append:
+    new parameters go at the end of parameterIDs (the count in the header says
+    how many a blob holds), and new sections (quality, IR data) follow the
+    cabinet, where older readers ignore them. Blobs that don't start with the
+    magic, such as the XML saved by earlier versions, are left to the caller.
+*/
+namespace BinaryState
+{
+    constexpr juce::uint32 magic = 0x53416d43;   // "CAmS"
+    constexpr int layoutVersion = 1;
+    constexpr int headerSize = 16;
+
+    /** Parameter order of the layout. Append only: never reorder or remove. */
+    constexpr int numParameters = 11;
+    extern const char* const parameterIDs[numParameters];
+
+    struct Contents
+    {
+        int stateVersion = 0;                 // The processor's StateVersion when saved
+        float parameters[numParameters] {};   // Parameter units, in parameterIDs order
+        int numStoredParameters = 0;          // How many the blob held (the rest keep their values)
+
+        bool cabinetMinimumPhase = false;
+        double cabinetMaximumLengthSeconds = 0.0;
+        juce::String cabinetFile;             // Empty for the built-in IR
+    };
+
+    /** True if the data starts with a binary state header. */
+    bool isBinaryState (const void* data, int sizeInBytes) noexcept;
+
+    /** Replaces destData with the encoded contents (all numParameters of them). */
+    void write (const Contents& contents, juce::MemoryBlock& destData);
+
+    /** Decodes a blob. Returns false, leaving contents unspecified, if it is
+        not binary state or is truncated.
+    */
+    bool read (const void* data, int sizeInBytes, Contents& contents);
+}
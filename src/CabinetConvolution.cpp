@@ -0,0 +1,426 @@
+#include "CabinetConvolution.h"
+#include "CabinetImpulseResponse.h"
+
+//==============================================================================
+namespace
+{
+    // An empty source means the built-in IR, generated at the target rate
+    juce::AudioBuffer<float> makeImpulseResponse (const juce::AudioBuffer<float>& source, double sourceSampleRate,
+                                                  const CabinetConvolution::Options& options, double sampleRate)
+    {
+        auto ir = source.getNumSamples() > 0 ? CabinetImpulseResponse::resample (source, sourceSampleRate, sampleRate)
+                                             : CabinetImpulseResponse::createSynthetic (sampleRate, 1);
+
+        if (options.maximumLengthSeconds > 0.0)
+            CabinetImpulseResponse::truncate (ir, juce::roundToInt (sampleRate * options.maximumLengthSeconds));
+
+        if (options.minimumPhase)
+            CabinetImpulseResponse::makeMinimumPhase (ir);
+
+        CabinetImpulseResponse::normalise (ir);
+        return ir;
+    }
+}
+
+//==============================================================================
+/** One PartitionedConvolution and one fitted lite model per channel. */
+struct CabinetConvolution::Engine
+{
+    static std::unique_ptr<Engine> create (const juce::AudioBuffer<float>& source, double sourceSampleRate,
+                                           const Options& options, double sampleRate, int numChannels)
+    {
+        auto ir = makeImpulseResponse (source, sourceSampleRate, options, sampleRate);
+
+        // Mono IRs feed every channel; stereo IRs map left/right
+        auto engine = std::make_unique<Engine>();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto irChannel = juce::jmin (channel, ir.getNumChannels() - 1);
+            auto* convolution = engine->channels.add (new PartitionedConvolution());
+
+            // Channels sharing an IR share its partitions and its fit (the slow part)
+            if (irChannel < channel)
+            {
+                convolution->shareImpulseResponse (*engine->channels[irChannel]);
+                engine->liteModels.add (new CabinetLiteModel (*engine->liteModels[irChannel]));
+            }
+            else
+            {
+                convolution->setImpulseResponse (ir.getReadPointer (irChannel), ir.getNumSamples());
+                engine->liteModels.add (new CabinetLiteModel())->fit (ir.getReadPointer (irChannel), ir.getNumSamples(), sampleRate);
+
+                auto error = engine->liteModels.getLast()->getFitError();
+                engine->liteFitError.rmsDecibels = juce::jmax (engine->liteFitError.rmsDecibels, error.rmsDecibels);
+                engine->liteFitError.maximumDecibels = juce::jmax (engine->liteFitError.maximumDecibels, error.maximumDecibels);
+            }
+        }
+
+        return engine;
+    }
+
+    void process (const juce::dsp::AudioBlock<float>& block, Mode mode) noexcept
+    {
+        jassert (block.getNumChannels() <= static_cast<size_t> (channels.size()));
+        auto numChannels = juce::jmin (block.getNumChannels(), static_cast<size_t> (channels.size()));
+        auto numSamples = static_cast<int> (block.getNumSamples());
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = block.getChannelPointer (channel);
+
+            if (mode == Mode::lite)
+                liteModels.getUnchecked (static_cast<int> (channel))->process (data, numSamples);
+            else
+                channels.getUnchecked (static_cast<int> (channel))->process (data, data, numSamples);
+        }
+    }
+
+    int getImpulseResponseLength() const noexcept
+    {
+        return channels.isEmpty() ? 0 : channels.getFirst()->getImpulseResponseLength();
+    }
+
+    void reset (Mode mode) noexcept
+    {
+        if (mode == Mode::lite)
+            for (auto* model : liteModels)
+                model->reset();
+        else
+            for (auto* channel : channels)
+                channel->reset();
+    }
+
+    juce::OwnedArray<PartitionedConvolution> channels;
+    juce::OwnedArray<CabinetLiteModel> liteModels;
+    CabinetLiteModel::FitError liteFitError;  // Worst channel
+};
+
+//==============================================================================
+/** State the message thread, loader jobs and audio thread exchange. */
+struct CabinetConvolution::LoadState
+{
+    ~LoadState()
+    {
+        delete pending.exchange (nullptr);
+        delete retired.exchange (nullptr);
+    }
+
+    // Message thread and loader jobs only
+    juce::CriticalSection lock;
+    juce::AudioBuffer<float> source;  // Empty for the built-in IR
+    double sourceSampleRate = 0.0;
+    juce::File file, requestedFile;  // Of the current IR and of the newest load (none for the built-in IR)
+    Options options;
+    CabinetLiteModel::FitError liteFitError;  // Of the newest engine
+    double sampleRate = 0.0;
+    int numChannels = 0;
+    int request = 0, preparation = 0;  // Newest load request and prepare() call
+
+    // Engines travelling to (pending) and from (retired) the audio thread
+    std::atomic<Engine*> pending { nullptr }, retired { nullptr };
+};
+
+/** One loader thread for every cabinet in the process. */
+struct CabinetConvolution::LoaderPool
+{
+    juce::ThreadPool pool { juce::ThreadPoolOptions{}.withThreadName ("Cabinet IR loader")
+                                                     .withNumberOfThreads (1) };
+};
+
+//==============================================================================
+CabinetConvolution::CabinetConvolution()
+    : state (std::make_shared<LoadState>())
+{
+}
+
+CabinetConvolution::~CabinetConvolution() = default;
+
+juce::AudioBuffer<float> CabinetConvolution::createBuiltInImpulseResponse (double sampleRate)
+{
+    return makeImpulseResponse ({}, 0.0, {}, sampleRate);
+}
+
+void CabinetConvolution::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    crossfadeLength = juce::jmax (1, juce::roundToInt (spec.sampleRate * crossfadeSeconds));
+    crossfadePosition = crossfadeLength;
+
+    if (static_cast<int> (spec.maximumBlockSize) > crossfadeBuffer.getNumSamples()
+         || static_cast<int> (spec.numChannels) != crossfadeBuffer.getNumChannels())
+        crossfadeBuffer.setSize (static_cast<int> (spec.numChannels), static_cast<int> (spec.maximumBlockSize));
+
+    // Same rate and channel count: the engine (and any IR on its way) still fits
+    {
+        const juce::ScopedLock sl (state->lock);
+
+        if (current != nullptr && state->sampleRate == spec.sampleRate
+             && state->numChannels == static_cast<int> (spec.numChannels))
+        {
+            reset();
+            return;
+        }
+    }
+
+    juce::AudioBuffer<float> source;
+    double sourceSampleRate;
+    Options options;
+
+    {
+        const juce::ScopedLock sl (state->lock);
+        state->sampleRate = spec.sampleRate;
+        state->numChannels = static_cast<int> (spec.numChannels);
+        ++state->preparation;  // Engines still being built are for the old spec
+
+        source = state->source;
+        sourceSampleRate = state->sourceSampleRate;
+        options = state->options;
+    }
+
+    delete state->pending.exchange (nullptr);
+    previous.reset();
+
+    current = Engine::create (source, sourceSampleRate, options, spec.sampleRate, static_cast<int> (spec.numChannels));
+    updateTailLength();
+
+    const juce::ScopedLock sl (state->lock);
+    state->liteFitError = current->liteFitError;
+}
+
+void CabinetConvolution::reset() noexcept
+{
+    if (current != nullptr)
+    {
+        current->reset (Mode::full);
+        current->reset (Mode::lite);
+    }
+
+    // Drop any crossfade in progress; the old engine is retired in process()
+    crossfadePosition = crossfadeLength;
+}
+
+void CabinetConvolution::process (const juce::dsp::ProcessContextReplacing<float>& context, Mode mode) noexcept
+{
+    if (current == nullptr)
+        return;
+
+    // The model switched to has been idle: start it clean rather than from stale state
+    if (mode != currentMode)
+    {
+        current->reset (mode);
+
+        if (previous != nullptr)
+            previous->reset (mode);
+
+        currentMode = mode;
+    }
+
+    // Finished with the old engine: hand it back once the slot is free
+    if (previous != nullptr && crossfadePosition >= crossfadeLength)
+    {
+        Engine* expected = nullptr;
+
+        if (state->retired.compare_exchange_strong (expected, previous.get()))
+        {
+            juce::ignoreUnused (previous.release());
+            updateTailLength();
+        }
+    }
+
+    // A new IR is ready: it takes over and the current one fades out
+    if (previous == nullptr)
+    {
+        if (auto* next = state->pending.exchange (nullptr))
+        {
+            previous = std::move (current);
+            current.reset (next);
+            crossfadePosition = 0;
+            updateTailLength();
+        }
+    }
+
+    auto& block = context.getOutputBlock();
+
+    if (previous == nullptr || crossfadePosition >= crossfadeLength)
+    {
+        current->process (block, mode);
+        return;
+    }
+
+    // Both engines see the same input; the output ramps linearly from old to new
+    auto maximumChunk = static_cast<size_t> (crossfadeBuffer.getNumSamples());
+
+    for (size_t start = 0; start < block.getNumSamples(); start += maximumChunk)
+    {
+        auto newBlock = block.getSubBlock (start, juce::jmin (maximumChunk, block.getNumSamples() - start));
+        auto oldBlock = juce::dsp::AudioBlock<float> (crossfadeBuffer).getSubsetChannelBlock (0, newBlock.getNumChannels())
+                                                                       .getSubBlock (0, newBlock.getNumSamples());
+        oldBlock.copyFrom (newBlock);
+
+        previous->process (oldBlock, mode);
+        current->process (newBlock, mode);
+
+        for (size_t channel = 0; channel < newBlock.getNumChannels(); ++channel)
+        {
+            auto* output = newBlock.getChannelPointer (channel);
+            auto* faded = oldBlock.getChannelPointer (channel);
+
+            for (size_t i = 0; i < newBlock.getNumSamples(); ++i)
+            {
+                auto gain = juce::jmin (1.0f, static_cast<float> (crossfadePosition + static_cast<int> (i))
+                                            / static_cast<float> (crossfadeLength));
+                output[i] = faded[i] + gain * (output[i] - faded[i]);
+            }
+        }
+
+        crossfadePosition += static_cast<int> (newBlock.getNumSamples());
+    }
+}
+
+void CabinetConvolution::updateTailLength() noexcept
+{
+    auto length = current != nullptr ? current->getImpulseResponseLength() : 0;
+
+    if (previous != nullptr)
+        length = juce::jmax (length, previous->getImpulseResponseLength());
+
+    tailLength.store (length, std::memory_order_relaxed);
+}
+
+//==============================================================================
+bool CabinetConvolution::loadImpulseResponse (const juce::File& file)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    // Only the header is read here; decoding happens on the loader thread
+    std::shared_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (file));
+
+    if (reader == nullptr)
+        return false;
+
+    int request;
+    {
+        const juce::ScopedLock sl (state->lock);
+        state->requestedFile = file;
+        request = ++state->request;
+    }
+
+    startJob (std::move (reader), file, request);
+    return true;
+}
+
+void CabinetConvolution::loadBuiltIn()
+{
+    int request;
+    {
+        const juce::ScopedLock sl (state->lock);
+        state->source.setSize (0, 0);
+        state->file = state->requestedFile = juce::File();
+        request = ++state->request;
+    }
+
+    startJob (nullptr, {}, request);
+}
+
+void CabinetConvolution::setOptions (const Options& newOptions)
+{
+    int request;
+    {
+        const juce::ScopedLock sl (state->lock);
+
+        if (state->options == newOptions)
+            return;
+
+        state->options = newOptions;
+        request = ++state->request;
+    }
+
+    startJob (nullptr, {}, request);
+}
+
+CabinetConvolution::Options CabinetConvolution::getOptions() const
+{
+    const juce::ScopedLock sl (state->lock);
+    return state->options;
+}
+
+juce::File CabinetConvolution::getImpulseResponseFile() const
+{
+    const juce::ScopedLock sl (state->lock);
+    return state->file;
+}
+
+bool CabinetConvolution::isRequestedSource (const juce::File& file) const
+{
+    const juce::ScopedLock sl (state->lock);
+    return state->requestedFile == file;
+}
+
+CabinetLiteModel::FitError CabinetConvolution::getLiteFitError() const
+{
+    const juce::ScopedLock sl (state->lock);
+    return state->liteFitError;
+}
+
+void CabinetConvolution::startJob (std::shared_ptr<juce::AudioFormatReader> reader, const juce::File& file, int request)
+{
+    loader->pool.addJob ([loadState = state, reader, file, request]
+    {
+        auto& s = *loadState;
+
+        // Newer requests supersede this one at every step
+        if (reader != nullptr)
+        {
+            auto ir = CabinetImpulseResponse::readFile (*reader);
+            const juce::ScopedLock sl (s.lock);
+
+            // Unreadable: the current IR stays in use, and asking for the file again retries it
+            if (ir.getNumSamples() == 0)
+            {
+                if (request == s.request)
+                    s.requestedFile = s.file;
+
+                return;
+            }
+
+            if (request != s.request)
+                return;
+
+            s.source = std::move (ir);
+            s.sourceSampleRate = reader->sampleRate;
+            s.file = file;
+        }
+
+        juce::AudioBuffer<float> source;
+        double sourceSampleRate, sampleRate;
+        int numChannels, preparation;
+        Options options;
+
+        {
+            const juce::ScopedLock sl (s.lock);
+
+            if (request != s.request || s.sampleRate <= 0.0)
+                return;  // Superseded, or not prepared yet (prepare() builds it)
+
+            source = s.source;
+            sourceSampleRate = s.sourceSampleRate;
+            options = s.options;
+            sampleRate = s.sampleRate;
+            numChannels = s.numChannels;
+            preparation = s.preparation;
+        }
+
+        auto engine = Engine::create (source, sourceSampleRate, options, sampleRate, numChannels);
+
+        const juce::ScopedLock sl (s.lock);
+
+        if (request != s.request || preparation != s.preparation)
+            return;
+
+        // Free whatever the audio thread handed back, and any engine it never picked up
+        s.liteFitError = engine->liteFitError;
+        delete s.retired.exchange (nullptr);
+        delete s.pending.exchange (engine.release());
+    });
+}
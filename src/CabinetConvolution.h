@@ -0,0 +1,117 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_dsp/juce_dsp.h>
+
+#include "CabinetLiteModel.h"
+#include "PartitionedConvolution.h"
+
+//==============================================================================
+/**
+    Cabinet stage: zero-latency convolution with the built-in 4x12 IR or a
+    user IR file, or a fitted biquad cascade of the same IR (lite mode).
+
+    New IRs are read, resampled, trimmed and partitioned on a shared background
+    thread, then handed to the audio thread through an atomic slot. process()
+    picks them up and crossfades from the old IR, so a swap never blocks or
+    clicks. The engine being replaced is handed back the same way and freed by
+    the next load, never on the audio thread.
+*/
+class CabinetConvolution
+{
+public:
+    //==============================================================================
+    struct Options
+    {
+        bool minimumPhase = false;          // Convert to minimum phase (removes pre-delay)
+        double maximumLengthSeconds = 0.0;  // Truncate longer IRs (0 = keep the whole IR)
+
+        bool operator== (const Options& other) const noexcept
+        {
+            return minimumPhase == other.minimumPhase && maximumLengthSeconds == other.maximumLengthSeconds;
+        }
+    };
+
+    /** Full convolution, or the CabinetLiteModel fitted to the same IR. */
+    enum class Mode
+    {
+        full,
+        lite
+    };
+
+    static constexpr double crossfadeSeconds = 0.05;
+
+    CabinetConvolution();
+    ~CabinetConvolution();
+
+    /** Builds the current IR for this spec right away, so processing starts
+        with it. With the same rate and channel count as before, it only clears
+        the state. Not realtime safe.
+    */
+    void prepare (const juce::dsp::ProcessSpec& spec);
+
+    void reset() noexcept;
+
+    /** Switching modes restarts the newly selected model from silence. */
+    void process (const juce::dsp::ProcessContextReplacing<float>& context, Mode mode = Mode::full) noexcept;
+
+    /** Always zero: the convolution needs no look-ahead. */
+    int getLatency() const noexcept     { return 0; }
+
+    /** Samples the output rings on after the input stops: the length of the IR
+        in use (the longer one during a crossfade). Safe from any thread.
+    */
+    int getTailLength() const noexcept  { return tailLength.load (std::memory_order_relaxed); }
+
+    //==============================================================================
+    /** Starts loading an IR file in the background. Returns false (keeping the
+        current IR) if the file is not a readable audio file.
+    */
+    bool loadImpulseResponse (const juce::File& file);
+
+    /** Switches back to the built-in IR. */
+    void loadBuiltIn();
+
+    /** Changes truncation/minimum-phase and rebuilds the current IR. */
+    void setOptions (const Options& newOptions);
+    Options getOptions() const;
+
+    /** File the current IR came from (none for the built-in IR). */
+    juce::File getImpulseResponseFile() const;
+
+    /** True if the newest load asked for this file (an empty File for the
+        built-in IR), whether or not it has finished loading.
+    */
+    bool isRequestedSource (const juce::File& file) const;
+
+    /** The built-in IR at a sample rate, exactly as a cabinet with default
+        options convolves it (mono). Not realtime safe.
+    */
+    static juce::AudioBuffer<float> createBuiltInImpulseResponse (double sampleRate);
+
+    /** How far the lite model of the newest IR is from its full response. */
+    CabinetLiteModel::FitError getLiteFitError() const;
+
+private:
+    //==============================================================================
+    struct Engine;
+    struct LoadState;
+    struct LoaderPool;
+
+    void startJob (std::shared_ptr<juce::AudioFormatReader> reader, const juce::File& file, int request);
+
+    // Audio thread side
+    std::unique_ptr<Engine> current, previous;
+    juce::AudioBuffer<float> crossfadeBuffer;
+    int crossfadeLength = 0, crossfadePosition = 0;
+    Mode currentMode = Mode::full;
+    std::atomic<int> tailLength { 0 };
+    void updateTailLength() noexcept;
+
+    // Shared with the loader jobs, which may outlive this object
+    std::shared_ptr<LoadState> state;
+    juce::SharedResourcePointer<LoaderPool> loader;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CabinetConvolution)
+};
@@ -0,0 +1,168 @@
+#include "CabinetImpulseResponse.h"
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+juce::AudioBuffer<float> CabinetImpulseResponse::createSynthetic (double sampleRate, int numChannels)
+{
+    // Create a simple impulse response for Marshall 4x12 cabinet simulation
+    // TODO: Replace with actual measured IR from real Marshall cabinet
+    // This is a basic synthetic IR approximating speaker resonance and room
+    const int irLength = 2048;  // ~40ms @ 48kHz
+    juce::AudioBuffer<float> ir (numChannels, irLength);
+
+    for (int channel = 0; channel < ir.getNumChannels(); ++channel)
+    {
+        auto* irData = ir.getWritePointer (channel);
+
+        // Initial impulse with speaker resonance (~80 Hz)
+        for (int i = 0; i < irLength; ++i)
+        {
+            float t = static_cast<float> (i) / static_cast<float> (sampleRate);
+
+            // Direct impulse
+            float direct = (i == 0) ? 0.8f : 0.0f;
+
+            // Speaker resonance (damped sine wave at 80 Hz)
+            float resonance = std::sin (2.0f * juce::MathConstants<float>::pi * 80.0f * t)
+                            * std::exp (-t * 50.0f) * 0.3f;
+
+            // High-frequency rolloff (speaker cone breakup ~4 kHz)
+            float envelope = std::exp (-t * 8.0f);
+
+            // Early reflections (simulated cabinet and room)
+            float reflection1 = (i == 64) ? 0.15f : 0.0f;   // ~1.3ms
+            float reflection2 = (i == 128) ? 0.08f : 0.0f;  // ~2.7ms
+            float reflection3 = (i == 256) ? 0.04f : 0.0f;  // ~5.3ms
+
+            irData[i] = (direct + resonance + reflection1 + reflection2 + reflection3) * envelope;
+        }
+    }
+
+    return ir;
+}
+
+juce::AudioBuffer<float> CabinetImpulseResponse::readFile (juce::AudioFormatReader& reader, double maximumSeconds)
+{
+    auto length = static_cast<int> (juce::jmin (reader.lengthInSamples,
+                                                static_cast<juce::int64> (reader.sampleRate * maximumSeconds)));
+
+    if (length <= 0 || reader.numChannels == 0)
+        return {};
+
+    juce::AudioBuffer<float> ir (static_cast<int> (reader.numChannels), length);
+
+    if (! reader.read (&ir, 0, length, 0, true, true))
+        return {};
+
+    return ir;
+}
+
+juce::AudioBuffer<float> CabinetImpulseResponse::resample (const juce::AudioBuffer<float>& ir, double sourceRate, double destinationRate)
+{
+    if (juce::approximatelyEqual (sourceRate, destinationRate))
+        return ir;
+
+    auto ratio = sourceRate / destinationRate;
+    auto length = juce::roundToInt (juce::jmax (1.0, ir.getNumSamples() / ratio));
+
+    juce::AudioBuffer<float> source (ir);
+    juce::MemoryAudioSource memorySource (source, false);
+    juce::ResamplingAudioSource resampler (&memorySource, false, ir.getNumChannels());
+    resampler.setResamplingRatio (ratio);
+    resampler.prepareToPlay (length, sourceRate);
+
+    juce::AudioBuffer<float> result (ir.getNumChannels(), length);
+    resampler.getNextAudioBlock ({ &result, 0, length });
+    return result;
+}
+
+void CabinetImpulseResponse::truncate (juce::AudioBuffer<float>& ir, int maximumLength)
+{
+    if (maximumLength <= 0 || ir.getNumSamples() <= maximumLength)
+        return;
+
+    ir.setSize (ir.getNumChannels(), maximumLength, true);
+
+    // Half-cosine fade over the last eighth of what is left
+    auto fadeLength = juce::jmax (1, maximumLength / 8);
+    auto fadeStart = maximumLength - fadeLength;
+
+    for (int channel = 0; channel < ir.getNumChannels(); ++channel)
+    {
+        auto* data = ir.getWritePointer (channel);
+
+        for (int i = 0; i < fadeLength; ++i)
+            data[fadeStart + i] *= 0.5f + 0.5f * std::cos (juce::MathConstants<float>::pi * static_cast<float> (i + 1)
+                                                           / static_cast<float> (fadeLength));
+    }
+}
+
+void CabinetImpulseResponse::makeMinimumPhase (juce::AudioBuffer<float>& ir)
+{
+    // Zero-padded well past the IR so the cepstrum does not alias
+    auto order = juce::jmax (4, juce::roundToInt (std::ceil (std::log2 (static_cast<double> (ir.getNumSamples())))) + 2);
+    juce::dsp::FFT fft (order);
+    auto size = fft.getSize();
+
+    std::vector<juce::dsp::Complex<float>> spectrum (static_cast<size_t> (size));
+    std::vector<juce::dsp::Complex<float>> scratch (static_cast<size_t> (size));
+
+    for (int channel = 0; channel < ir.getNumChannels(); ++channel)
+    {
+        auto* data = ir.getWritePointer (channel);
+
+        std::fill (scratch.begin(), scratch.end(), juce::dsp::Complex<float>());
+        for (int i = 0; i < ir.getNumSamples(); ++i)
+            scratch[static_cast<size_t> (i)] = data[i];
+
+        // Real cepstrum of the log magnitude
+        fft.perform (scratch.data(), spectrum.data(), false);
+
+        for (auto& bin : spectrum)
+            bin = std::log (juce::jmax (std::abs (bin), 1.0e-9f));
+
+        fft.perform (spectrum.data(), scratch.data(), true);
+
+        // Fold the anti-causal part onto the causal part
+        for (int i = 1; i < size / 2; ++i)
+        {
+            scratch[static_cast<size_t> (i)] = 2.0f * scratch[static_cast<size_t> (i)].real();
+            scratch[static_cast<size_t> (size - i)] = 0.0f;
+        }
+
+        scratch[0] = scratch[0].real();
+        scratch[static_cast<size_t> (size / 2)] = scratch[static_cast<size_t> (size / 2)].real();
+
+        // Back to a spectrum with the same magnitude and minimum phase
+        fft.perform (scratch.data(), spectrum.data(), false);
+
+        for (auto& bin : spectrum)
+            bin = std::exp (bin);
+
+        fft.perform (spectrum.data(), scratch.data(), true);
+
+        for (int i = 0; i < ir.getNumSamples(); ++i)
+            data[i] = scratch[static_cast<size_t> (i)].real();
+    }
+}
+
+void CabinetImpulseResponse::normalise (juce::AudioBuffer<float>& ir)
+{
+    // Loudest channel's energy to a fixed level (same factor as juce::dsp::Convolution)
+    float maximumEnergy = 0.0f;
+
+    for (int channel = 0; channel < ir.getNumChannels(); ++channel)
+    {
+        auto* data = ir.getReadPointer (channel);
+        float energy = 0.0f;
+
+        for (int i = 0; i < ir.getNumSamples(); ++i)
+            energy += data[i] * data[i];
+
+        maximumEnergy = juce::jmax (maximumEnergy, energy);
+    }
+
+    if (maximumEnergy > 0.0f)
+        ir.applyGain (0.125f / std::sqrt (maximumEnergy));
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+//==============================================================================
+/** Impulse responses for the cabinet convolution stage. None of these are
+    realtime safe.
+*/
+namespace CabinetImpulseResponse
+{
+    /** Synthetic Marshall 4x12 approximation (speaker resonance plus early
+        reflections), the same on every channel.
+    */
+    juce::AudioBuffer<float> createSynthetic (double sampleRate, int numChannels);
+
+    /** Reads an IR file (any format the basic formats support), keeping at
+        most maximumSeconds of it. Returns an empty buffer on failure.
+    */
+    juce::AudioBuffer<float> readFile (juce::AudioFormatReader& reader, double maximumSeconds = 10.0);
+
+    /** Converts an IR from one sample rate to another (band-limited when
+        going down, as juce::dsp::Convolution does it).
+    */
+    juce::AudioBuffer<float> resample (const juce::AudioBuffer<float>& ir, double sourceRate, double destinationRate);
+
+    /** Shortens an IR to at most maximumLength samples, fading the end out so
+        the cut does not ring.
+    */
+    void truncate (juce::AudioBuffer<float>& ir, int maximumLength);
+
+    /** Replaces each channel with the minimum-phase IR of the same magnitude
+        response (homomorphic method). Pre-delay and pre-ringing are removed,
+        and the energy moves as close to the start as the response allows.
+    */
+    void makeMinimumPhase (juce::AudioBuffer<float>& ir);
+
+    /** Scales an IR the way juce::dsp::Convolution::Normalise::yes does, so
+        every IR plays at a similar level.
+    */
+    void normalise (juce::AudioBuffer<float>& ir);
+}
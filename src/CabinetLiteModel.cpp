@@ -0,0 +1,322 @@
+#include "CabinetLiteModel.h"
+
+#include <numeric>
+
+namespace
+{
+    //==============================================================================
+    constexpr int numGridPoints = 160;
+    constexpr double lowestFrequency = 30.0;
+    constexpr double highestFrequency = 18000.0;
+    constexpr int maximumFitLength = 65536;   // Samples of the IR that shape the fit
+
+    enum class SectionType { highPass, lowPass, peak };
+
+    struct Section
+    {
+        SectionType type;
+        double frequency, q, gainDecibels;
+    };
+
+    std::array<double, 6> design (const Section& section, double sampleRate)
+    {
+        using Coefficients = juce::dsp::IIR::ArrayCoefficients<double>;
+
+        switch (section.type)
+        {
+            case SectionType::highPass:  return Coefficients::makeHighPass (sampleRate, section.frequency, section.q);
+            case SectionType::lowPass:   return Coefficients::makeLowPass (sampleRate, section.frequency, section.q);
+            case SectionType::peak:      break;
+        }
+
+        return Coefficients::makePeakFilter (sampleRate, section.frequency, section.q,
+                                             juce::Decibels::decibelsToGain (section.gainDecibels, -300.0));
+    }
+
+    //==============================================================================
+    /** Pattern search over section parameters against a dB target on a log grid. */
+    class Fitter
+    {
+    public:
+        Fitter (double rate, std::vector<double> gridFrequencies, std::vector<double> targetDecibels)
+            : sampleRate (rate), frequencies (std::move (gridFrequencies)), target (std::move (targetDecibels))
+        {
+            for (auto frequency : frequencies)
+                delays.push_back (std::polar (1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate));
+
+            model.resize (frequencies.size(), 0.0);
+            candidateModel.resize (frequencies.size(), 0.0);
+        }
+
+        void addSection (const Section& section)
+        {
+            sections.push_back (section);
+            responses.push_back (getResponse (section));
+
+            for (size_t k = 0; k < model.size(); ++k)
+                model[k] += responses.back()[k];
+        }
+
+        double getError() const                                   { return getError (model); }
+        double getOffset() const                                  { return getOffset (model); }
+        const std::vector<Section>& getSections() const noexcept  { return sections; }
+
+        /** Model response on the grid, in dB (without the offset). */
+        const std::vector<double>& getModel() const noexcept      { return model; }
+
+        /** Tries every frequency/Q pair on a coarse grid for one section. */
+        void search (size_t index, double lowFrequency, double highFrequency)
+        {
+            auto best = getError();
+
+            for (auto frequency = lowFrequency; frequency <= highFrequency; frequency *= std::pow (2.0, 0.25))
+            {
+                for (auto q : { 0.5, 0.707, 1.0, 1.5 })
+                {
+                    auto candidate = sections[index];
+                    candidate.frequency = frequency;
+                    candidate.q = q;
+
+                    trySection (index, candidate, best);
+                }
+            }
+        }
+
+        /** Moves one section's parameters while the error keeps dropping. */
+        void refine (size_t index)
+        {
+            auto best = getError();
+            double steps[] = { 0.25, 0.5, 2.0 };  // Octaves, log2 Q, dB
+            auto numParameters = sections[index].type == SectionType::peak ? 3 : 2;
+
+            for (int iteration = 0; iteration < 200 && steps[0] > 0.005; ++iteration)
+            {
+                auto improved = false;
+
+                for (int parameter = 0; parameter < numParameters; ++parameter)
+                {
+                    for (auto direction : { 1.0, -1.0 })
+                    {
+                        auto candidate = sections[index];
+                        auto step = direction * steps[parameter];
+
+                        if (parameter == 0)
+                            candidate.frequency = juce::jlimit (20.0, getHighestFrequency(), candidate.frequency * std::pow (2.0, step));
+                        else if (parameter == 1)
+                            candidate.q = juce::jlimit (0.3, 10.0, candidate.q * std::pow (2.0, step));
+                        else
+                            candidate.gainDecibels = juce::jlimit (-24.0, 24.0, candidate.gainDecibels + step);
+
+                        if (trySection (index, candidate, best))
+                            improved = true;
+                    }
+                }
+
+                if (! improved)
+                    for (auto& step : steps)
+                        step *= 0.5;
+            }
+        }
+
+        double getHighestFrequency() const noexcept  { return 0.45 * sampleRate; }
+
+    private:
+        bool trySection (size_t index, const Section& candidate, double& best)
+        {
+            auto response = getResponse (candidate);
+
+            for (size_t k = 0; k < model.size(); ++k)
+                candidateModel[k] = model[k] - responses[index][k] + response[k];
+
+            auto error = getError (candidateModel);
+
+            if (error >= best)
+                return false;
+
+            best = error;
+            sections[index] = candidate;
+            responses[index] = std::move (response);
+            std::swap (model, candidateModel);
+            return true;
+        }
+
+        std::vector<double> getResponse (const Section& section) const
+        {
+            auto c = design (section, sampleRate);  // { b0, b1, b2, a0, a1, a2 }
+            std::vector<double> response (delays.size());
+
+            for (size_t k = 0; k < delays.size(); ++k)
+            {
+                auto z1 = delays[k];
+                auto z2 = z1 * z1;
+                auto numerator = c[0] + c[1] * z1 + c[2] * z2;
+                auto denominator = c[3] + c[4] * z1 + c[5] * z2;
+                response[k] = 20.0 * std::log10 (juce::jmax (1.0e-12, std::abs (numerator) / std::abs (denominator)));
+            }
+
+            return response;
+        }
+
+        // Level difference that the output gain absorbs
+        double getOffset (const std::vector<double>& modelDecibels) const
+        {
+            double sum = 0.0;
+
+            for (size_t k = 0; k < target.size(); ++k)
+                sum += target[k] - modelDecibels[k];
+
+            return sum / static_cast<double> (target.size());
+        }
+
+        // RMS dB difference once the level offset is taken out
+        double getError (const std::vector<double>& modelDecibels) const
+        {
+            auto offset = getOffset (modelDecibels);
+            double sum = 0.0;
+
+            for (size_t k = 0; k < target.size(); ++k)
+                sum += juce::square (target[k] - modelDecibels[k] - offset);
+
+            return std::sqrt (sum / static_cast<double> (target.size()));
+        }
+
+        double sampleRate;
+        std::vector<double> frequencies, target;
+        std::vector<std::complex<double>> delays;
+
+        std::vector<Section> sections;
+        std::vector<std::vector<double>> responses;
+        std::vector<double> model, candidateModel;  // Sum of the section responses
+    };
+}
+
+//==============================================================================
+void CabinetLiteModel::fit (const float* impulseResponse, int length, double sampleRate)
+{
+    // Magnitude response of the IR
+    auto fitLength = juce::jmin (length, maximumFitLength);
+    auto order = juce::jmax (13, juce::roundToInt (std::ceil (std::log2 (static_cast<double> (juce::jmax (1, fitLength))))) + 1);
+    juce::dsp::FFT fft (order);
+    auto size = fft.getSize();
+
+    std::vector<float> spectrum (static_cast<size_t> (2 * size), 0.0f);
+    std::copy (impulseResponse, impulseResponse + fitLength, spectrum.begin());
+    fft.performRealOnlyForwardTransform (spectrum.data(), true);
+
+    std::vector<double> power (static_cast<size_t> (size / 2 + 1));
+    for (size_t bin = 0; bin < power.size(); ++bin)
+        power[bin] = juce::square (static_cast<double> (spectrum[2 * bin])) + juce::square (static_cast<double> (spectrum[2 * bin + 1]));
+
+    // Log-spaced grid: 1/6-octave smoothed target for the fit, raw response for the error report
+    auto binWidth = sampleRate / static_cast<double> (size);
+    auto top = juce::jmin (highestFrequency, 0.45 * sampleRate);
+    auto toDecibels = [] (double p) { return 10.0 * std::log10 (juce::jmax (1.0e-24, p)); };
+
+    std::vector<double> frequencies, smoothed, raw;
+
+    for (int k = 0; k < numGridPoints; ++k)
+    {
+        auto frequency = lowestFrequency * std::pow (top / lowestFrequency, k / static_cast<double> (numGridPoints - 1));
+        frequencies.push_back (frequency);
+
+        auto low = static_cast<size_t> (std::floor (frequency * std::pow (2.0, -1.0 / 12.0) / binWidth));
+        auto high = juce::jmin (power.size() - 1, static_cast<size_t> (std::ceil (frequency * std::pow (2.0, 1.0 / 12.0) / binWidth)));
+        auto sum = std::accumulate (power.begin() + static_cast<std::ptrdiff_t> (low),
+                                    power.begin() + static_cast<std::ptrdiff_t> (high) + 1, 0.0);
+        smoothed.push_back (toDecibels (sum / static_cast<double> (high - low + 1)));
+
+        auto position = frequency / binWidth;
+        auto bin = juce::jmin (power.size() - 2, static_cast<size_t> (position));
+        auto fraction = position - static_cast<double> (bin);
+        raw.push_back (toDecibels (juce::jmap (fraction, power[bin], power[bin + 1])));
+    }
+
+    // Band limits first, then peaks where the residual is largest
+    Fitter fitter (sampleRate, frequencies, smoothed);
+    fitter.addSection ({ SectionType::highPass, 80.0, 0.707, 0.0 });
+    fitter.addSection ({ SectionType::lowPass, juce::jmin (5000.0, fitter.getHighestFrequency()), 0.707, 0.0 });
+
+    fitter.search (0, 20.0, 400.0);
+    fitter.search (1, 1000.0, fitter.getHighestFrequency());
+    fitter.refine (0);
+    fitter.refine (1);
+
+    for (int peak = 0; peak < numPeakSections; ++peak)
+    {
+        auto& model = fitter.getModel();
+        auto offset = fitter.getOffset();
+        size_t worst = 0;
+
+        for (size_t k = 0; k < model.size(); ++k)
+            if (std::abs (smoothed[k] - model[k] - offset) > std::abs (smoothed[worst] - model[worst] - offset))
+                worst = k;
+
+        auto index = static_cast<size_t> (peak + 2);
+        fitter.addSection ({ SectionType::peak, frequencies[worst], 2.0,
+                             juce::jlimit (-24.0, 24.0, smoothed[worst] - model[worst] - offset) });
+        fitter.refine (index);
+    }
+
+    for (int pass = 0; pass < 2; ++pass)
+        for (size_t index = 0; index < static_cast<size_t> (numSections); ++index)
+            fitter.refine (index);
+
+    // Runtime coefficients
+    for (size_t index = 0; index < static_cast<size_t> (numSections); ++index)
+    {
+        auto c = design (fitter.getSections()[index], sampleRate);
+        auto& section = sections[index];
+        section.b0 = static_cast<float> (c[0] / c[3]);
+        section.b1 = static_cast<float> (c[1] / c[3]);
+        section.b2 = static_cast<float> (c[2] / c[3]);
+        section.a1 = static_cast<float> (c[4] / c[3]);
+        section.a2 = static_cast<float> (c[5] / c[3]);
+    }
+
+    auto offset = fitter.getOffset();
+    gain = static_cast<float> (juce::Decibels::decibelsToGain (offset, -300.0));
+
+    // Report against the unsmoothed response of the IR the full mode convolves with
+    auto& model = fitter.getModel();
+    double sumSquares = 0.0, maximum = 0.0;
+
+    for (size_t k = 0; k < model.size(); ++k)
+    {
+        auto difference = std::abs (raw[k] - model[k] - offset);
+        sumSquares += difference * difference;
+        maximum = juce::jmax (maximum, difference);
+    }
+
+    fitError.rmsDecibels = static_cast<float> (std::sqrt (sumSquares / static_cast<double> (model.size())));
+    fitError.maximumDecibels = static_cast<float> (maximum);
+
+    reset();
+}
+
+void CabinetLiteModel::reset() noexcept
+{
+    for (auto& section : sections)
+        section.s1 = section.s2 = 0.0f;
+}
+
+void CabinetLiteModel::process (float* data, int numSamples) noexcept
+{
+    juce::FloatVectorOperations::multiply (data, gain, numSamples);
+
+    for (auto& section : sections)
+    {
+        auto s1 = section.s1, s2 = section.s2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto x = data[i];
+            auto y = x * section.b0 + s1;
+            s1 = x * section.b1 - y * section.a1 + s2;
+            s2 = x * section.b2 - y * section.a2;
+            data[i] = y;
+        }
+
+        section.s1 = s1;
+        section.s2 = s2;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    "Cab lite": a cascade of biquads fitted to a cabinet IR.
+
+    fit() matches the IR's 1/6-octave smoothed magnitude response on a log
+    frequency grid with a highpass, a lowpass and a handful of peaking filters
+    (greedy placement on the largest residual, then pattern-search refinement
+    of every section). Cabinets are close to minimum phase, so matching the
+    magnitude with a minimum-phase cascade keeps the attack too. It runs with
+    zero latency at a fraction of the cost of the convolution, without the
+    fine comb structure of the room/mic part of the IR.
+*/
+class CabinetLiteModel
+{
+public:
+    //==============================================================================
+    static constexpr int numPeakSections = 6;
+    static constexpr int numSections = numPeakSections + 2;   // Highpass, lowpass, peaks
+
+    /** Magnitude difference between the model and the unsmoothed IR response
+        (30 Hz to 18 kHz, log-spaced).
+    */
+    struct FitError
+    {
+        float rmsDecibels = 0.0f;
+        float maximumDecibels = 0.0f;
+    };
+
+    /** Fits the cascade to an IR. Not realtime safe. */
+    void fit (const float* impulseResponse, int length, double sampleRate);
+
+    FitError getFitError() const noexcept   { return fitError; }
+
+    void reset() noexcept;
+
+    /** Filters numSamples samples in place. */
+    void process (float* data, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    struct Biquad
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float s1 = 0.0f, s2 = 0.0f;
+    };
+
+    Biquad sections[numSections];
+    float gain = 1.0f;
+    FitError fitError;
+};
@@ -0,0 +1,80 @@
+#include "DspLoadOverlay.h"
+
+#if CLAUDEAMP_PROFILING
+
+//==============================================================================
+DspLoadOverlay::DspLoadOverlay (DspProfiler& p)
+    : profiler (p), lastCounters (p.getCounters())
+{
+    setOpaque (true);
+    startTimerHz (refreshRateHz);
+}
+
+void DspLoadOverlay::timerCallback()
+{
+    auto counters = profiler.getCounters();
+    auto budget = counters.budgetNanoseconds - lastCounters.budgetNanoseconds;
+
+    float peaks[numSections];
+    profiler.takePeaks (peaks);
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        // Average over everything processed since the last refresh
+        if (budget > 0)
+            averageLoad[i] = static_cast<float> (counters.sectionNanoseconds[i] - lastCounters.sectionNanoseconds[i])
+                           / static_cast<float> (budget);
+
+        peakHistory[historyIndex][i] = peaks[i];
+
+        rollingMaxLoad[i] = 0.0f;
+
+        for (auto& entry : peakHistory)
+            rollingMaxLoad[i] = juce::jmax (rollingMaxLoad[i], entry[i]);
+    }
+
+    historyIndex = (historyIndex + 1) % historySize;
+    lastCounters = counters;
+
+    repaint();
+}
+
+void DspLoadOverlay::paint (juce::Graphics& g)
+{
+    auto marshallGold = juce::Colour (0xffd4af37);
+
+    g.fillAll (juce::Colours::black);
+    g.setFont (juce::Font (12.0f));
+
+    auto area = getLocalBounds().reduced (10, 4);
+    auto cellWidth = area.getWidth() / (numSections + 1);
+
+    auto drawCell = [&] (juce::Rectangle<int> cell, const juce::String& name, float average, float maximum)
+    {
+        auto bar = cell.removeFromBottom (6).reduced (4, 0);
+
+        g.setColour (marshallGold);
+        g.drawText (name + "  " + juce::String (average * 100.0f, 1) + "%  (max " + juce::String (maximum * 100.0f, 1) + "%)",
+                    cell, juce::Justification::centredLeft, true);
+
+        g.setColour (juce::Colours::darkgrey);
+        g.fillRect (bar);
+
+        g.setColour (maximum > 0.5f ? juce::Colours::red : marshallGold);
+        g.fillRect (bar.withWidth (juce::roundToInt (static_cast<float> (bar.getWidth()) * juce::jmin (1.0f, average))));
+    };
+
+    auto totalAverage = 0.0f;
+    auto totalMaximum = 0.0f;
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        drawCell (area.removeFromLeft (cellWidth), DspProfiler::getSectionName (i), averageLoad[i], rollingMaxLoad[i]);
+        totalAverage += averageLoad[i];
+        totalMaximum += rollingMaxLoad[i];  // Upper bound: section peaks need not coincide
+    }
+
+    drawCell (area, "Total", totalAverage, totalMaximum);
+}
+
+#endif
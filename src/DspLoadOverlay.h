@@ -0,0 +1,43 @@
+#pragma once
+
+#include "PluginProcessor.h"
+
+#if CLAUDEAMP_PROFILING
+
+//==============================================================================
+/**
+    Strip showing DSP load per processBlock section, as a percentage of the
+    block's realtime budget: the average over the last refresh and the largest
+    single block seen over the last few seconds.
+
+    Only compiled into profiling builds (CLAUDEAMP_PROFILING).
+*/
+class DspLoadOverlay final : public juce::Component,
+                             private juce::Timer
+{
+public:
+    explicit DspLoadOverlay (DspProfiler&);
+
+    void paint (juce::Graphics&) override;
+
+    static constexpr int preferredHeight = 40;
+
+private:
+    void timerCallback() override;
+
+    static constexpr int refreshRateHz = 10;
+    static constexpr int historySize = 3 * refreshRateHz;  // Rolling max over ~3 s
+    static constexpr int numSections = DspProfiler::numSections;
+
+    DspProfiler& profiler;
+    DspProfiler::Counters lastCounters;
+
+    float averageLoad[numSections] {};
+    float rollingMaxLoad[numSections] {};
+    float peakHistory[historySize][numSections] {};
+    int historyIndex = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DspLoadOverlay)
+};
+
+#endif
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <chrono>
+
+// Build with -DCLAUDEAMP_PROFILING=ON (CMake) to enable per-section timing.
+// When disabled the profiler and all timing scopes compile out entirely.
+#ifndef CLAUDEAMP_PROFILING
+ #define CLAUDEAMP_PROFILING 0
+#endif
+
+#if CLAUDEAMP_PROFILING
+
+//==============================================================================
+/**
+    Lock-free per-section DSP load counters.
+
+    The audio thread times sections of processBlock with steady_clock and adds
+    the elapsed time, together with the block's realtime budget, to atomic
+    counters. Readers on any thread take differences between snapshots to get
+    average load, and collect the per-block peak with an exchange, so reading
+    never blocks or waits on the audio thread.
+*/
+class DspProfiler
+{
+public:
+    //==============================================================================
+    enum Section
+    {
+        oversampling,   // processSamplesUp + processSamplesDown
+        chain,          // PlexiChain, power supply sag included
+        cabinet,        // cabinetIR convolution
+        numSections
+    };
+
+    static const char* getSectionName (int section) noexcept
+    {
+        const char* const names[] = { "Oversampling", "Chain", "Cabinet" };
+        return juce::isPositiveAndBelow (section, static_cast<int> (numSections)) ? names[section] : "";
+    }
+
+    /** Totals since the profiler was created, plus peaks since the last call to takePeaks(). */
+    struct Counters
+    {
+        std::uint64_t sectionNanoseconds[numSections] {};
+        std::uint64_t budgetNanoseconds = 0;
+    };
+
+    //==============================================================================
+    /** Audio thread: starts timing a block of numSamples at sampleRate. */
+    void beginBlock (int numSamples, double sampleRate) noexcept
+    {
+        blockBudget = static_cast<std::uint64_t> (static_cast<double> (numSamples) / sampleRate * 1.0e9);
+        std::fill (std::begin (blockSections), std::end (blockSections), std::uint64_t (0));
+    }
+
+    /** Audio thread: adds time spent in a section during the current block. */
+    void addTime (Section section, std::uint64_t nanoseconds) noexcept
+    {
+        blockSections[section] += nanoseconds;
+    }
+
+    /** Audio thread: publishes the current block's times. */
+    void endBlock() noexcept
+    {
+        if (blockBudget == 0)
+            return;
+
+        for (int i = 0; i < numSections; ++i)
+        {
+            totals[i].fetch_add (blockSections[i], std::memory_order_relaxed);
+            updatePeak (peaks[i], static_cast<float> (blockSections[i]) / static_cast<float> (blockBudget));
+        }
+
+        totalBudget.fetch_add (blockBudget, std::memory_order_release);
+    }
+
+    //==============================================================================
+    /** Any thread: reads the running totals. */
+    Counters getCounters() const noexcept
+    {
+        Counters counters;
+        counters.budgetNanoseconds = totalBudget.load (std::memory_order_acquire);
+
+        for (int i = 0; i < numSections; ++i)
+            counters.sectionNanoseconds[i] = totals[i].load (std::memory_order_relaxed);
+
+        return counters;
+    }
+
+    /** Any thread: returns each section's largest single-block load (fraction of
+        the block's budget) since the previous call, and resets it.
+    */
+    void takePeaks (float (&destination)[numSections]) noexcept
+    {
+        for (int i = 0; i < numSections; ++i)
+            destination[i] = peaks[i].exchange (0.0f, std::memory_order_relaxed);
+    }
+
+    //==============================================================================
+    /** Times the enclosing scope as one section. */
+    class ScopedSection
+    {
+    public:
+        ScopedSection (DspProfiler& p, Section s) noexcept
+            : profiler (p), section (s), start (std::chrono::steady_clock::now()) {}
+
+        ~ScopedSection() noexcept
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            profiler.addTime (section, static_cast<std::uint64_t> (
+                std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count()));
+        }
+
+    private:
+        DspProfiler& profiler;
+        Section section;
+        std::chrono::steady_clock::time_point start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedSection)
+    };
+
+    /** Brackets a whole processBlock call. */
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock (DspProfiler& p, int numSamples, double sampleRate) noexcept
+            : profiler (p)  { profiler.beginBlock (numSamples, sampleRate); }
+
+        ~ScopedBlock() noexcept  { profiler.endBlock(); }
+
+    private:
+        DspProfiler& profiler;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedBlock)
+    };
+
+private:
+    //==============================================================================
+    static void updatePeak (std::atomic<float>& peak, float value) noexcept
+    {
+        auto current = peak.load (std::memory_order_relaxed);
+
+        while (value > current && ! peak.compare_exchange_weak (current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Audio thread only
+    std::uint64_t blockSections[numSections] {};
+    std::uint64_t blockBudget = 0;
+
+    // Shared
+    std::atomic<std::uint64_t> totals[numSections] {};
+    std::atomic<std::uint64_t> totalBudget { 0 };
+    std::atomic<float> peaks[numSections] {};
+};
+
+ #define CLAUDEAMP_PROFILE_BLOCK(profiler, numSamples, sampleRate) \
+    const DspProfiler::ScopedBlock JUCE_JOIN_MACRO (profileBlock_, __LINE__) (profiler, numSamples, sampleRate)
+
+ #define CLAUDEAMP_PROFILE_SECTION(profiler, section) \
+    const DspProfiler::ScopedSection JUCE_JOIN_MACRO (profileSection_, __LINE__) (profiler, DspProfiler::section)
+
+#else
+
+ #define CLAUDEAMP_PROFILE_BLOCK(profiler, numSamples, sampleRate)
+ #define CLAUDEAMP_PROFILE_SECTION(profiler, section)
+
+#endif
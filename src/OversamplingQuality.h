@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+
+//==============================================================================
+/**
+    What each choice of the "oversampling" parameter runs, shared by
+    ClaudeAmpProcessor and AmpBank so both set up the same oversampler and
+    tube stages for it.
+*/
+namespace OversamplingQuality
+{
+    // Auto and 1x-8x use the plain tube tables, "1x ADAA" and "2x ADAA"
+    // antiderivative anti-aliasing
+    struct Quality
+    {
+        size_t oversamplingStages = 0;
+        bool antiderivative = false;
+    };
+
+    /** Oversampling stages the "Auto" quality setting picks for a host rate. */
+    inline size_t getAutoOversamplingStages (double sampleRate)
+    {
+        // Smallest factor that brings the internal rate close to 176.4-192 kHz:
+        // 44.1/48k → 4x, 88.2/96k → 2x, 176.4/192k → 1x, 32k → 8x
+        const double targetRate = 176400.0 * 0.9;
+        size_t stages = 0;
+
+        while (stages < 3 && sampleRate * static_cast<double> (1 << stages) < targetRate)
+            ++stages;
+
+        return stages;
+    }
+
+    /** The setup for a parameter choice (0 = Auto, 1 = 1x ... 4 = 8x, 5/6 = 1x/2x ADAA). */
+    inline Quality getQuality (int oversamplingChoice, double sampleRate)
+    {
+        switch (oversamplingChoice)
+        {
+            case 0:   return { getAutoOversamplingStages (sampleRate), false };
+            case 5:   return { 0, true };   // 1x ADAA
+            case 6:   return { 1, true };   // 2x ADAA
+            default:  break;
+        }
+
+        return { static_cast<size_t> (oversamplingChoice - 1), false };  // 1x→0 ... 8x→3
+    }
+}
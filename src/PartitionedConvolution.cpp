@@ -0,0 +1,232 @@
+#include "PartitionedConvolution.h"
+
+//==============================================================================
+/** One stretch of the IR, convolved with uniform partitions of one size
+    (overlap-save: FFT size is twice the partition size).
+*/
+struct PartitionedConvolution::Segment
+{
+    /** The IR partitions' spectra and the FFT for their size. Read-only once
+        built, so every convolution of the same IR shares them.
+    */
+    struct Kernel
+    {
+        Kernel (int partitionSize, int numPartitions, const float* impulseResponse, int available)
+            : fft (juce::roundToInt (std::log2 (2.0 * partitionSize)))
+        {
+            auto spectrumSize = 2 * (partitionSize + 1);
+            std::vector<float> buffer (static_cast<size_t> (4 * partitionSize));
+            partitions.resize (static_cast<size_t> (numPartitions * spectrumSize));
+
+            for (int k = 0; k < numPartitions; ++k)
+            {
+                std::fill (buffer.begin(), buffer.end(), 0.0f);
+
+                auto start = k * partitionSize;
+                auto length = juce::jlimit (0, partitionSize, available - start);
+                std::copy (impulseResponse + start, impulseResponse + start + length, buffer.begin());
+
+                fft.performRealOnlyForwardTransform (buffer.data(), true);
+                std::copy (buffer.begin(), buffer.begin() + spectrumSize, partitions.begin() + k * spectrumSize);
+            }
+        }
+
+        juce::dsp::FFT fft;
+        std::vector<float> partitions;  // IR partition spectra
+    };
+
+    Segment (int size, int segmentOffset, int count, std::shared_ptr<const Kernel> kernelToUse)
+        : partitionSize (size),
+          offset (segmentOffset),
+          numPartitions (count),
+          spectrumSize (2 * (size + 1)),
+          kernel (std::move (kernelToUse))
+    {
+        spectra.resize (static_cast<size_t> (numPartitions * spectrumSize));
+        input.resize (static_cast<size_t> (2 * partitionSize));
+        buffer.resize (static_cast<size_t> (4 * partitionSize));
+    }
+
+    void reset() noexcept
+    {
+        std::fill (spectra.begin(), spectra.end(), 0.0f);
+        std::fill (input.begin(), input.end(), 0.0f);
+        fill = 0;
+        spectrumIndex = 0;
+    }
+
+    /** Convolves the partition of input just completed. The first of the
+        returned partitionSize samples belongs offset samples after the first
+        sample of that input.
+    */
+    const float* run() noexcept
+    {
+        // Spectrum of the last two input partitions goes into the delay line
+        std::copy (input.begin(), input.end(), buffer.begin());
+        std::fill (buffer.begin() + 2 * partitionSize, buffer.end(), 0.0f);
+        kernel->fft.performRealOnlyForwardTransform (buffer.data(), true);
+
+        auto* newest = spectra.data() + spectrumIndex * spectrumSize;
+        std::copy (buffer.begin(), buffer.begin() + spectrumSize, newest);
+
+        // Sum of each delayed input spectrum times its IR partition
+        std::fill (buffer.begin(), buffer.end(), 0.0f);
+
+        for (int k = 0; k < numPartitions; ++k)
+        {
+            auto index = (spectrumIndex - k + numPartitions) % numPartitions;
+            auto* x = spectra.data() + index * spectrumSize;
+            auto* h = kernel->partitions.data() + k * spectrumSize;
+
+            for (int i = 0; i < spectrumSize; i += 2)
+            {
+                buffer[static_cast<size_t> (i)]     += x[i] * h[i]     - x[i + 1] * h[i + 1];
+                buffer[static_cast<size_t> (i + 1)] += x[i] * h[i + 1] + x[i + 1] * h[i];
+            }
+        }
+
+        kernel->fft.performRealOnlyInverseTransform (buffer.data());
+
+        spectrumIndex = (spectrumIndex + 1) % numPartitions;
+        std::copy (input.begin() + partitionSize, input.end(), input.begin());
+        fill = 0;
+
+        // Overlap-save: only the second half is free of circular wrap-around
+        return buffer.data() + partitionSize;
+    }
+
+    const int partitionSize, offset, numPartitions, spectrumSize;
+    const std::shared_ptr<const Kernel> kernel;
+
+    std::vector<float> spectra;     // Input spectra (frequency-domain delay line)
+    std::vector<float> input;       // Previous and current input partition
+    std::vector<float> buffer;      // FFT workspace
+
+    int fill = 0, spectrumIndex = 0;
+};
+
+//==============================================================================
+PartitionedConvolution::PartitionedConvolution()
+{
+    setImpulseResponse (nullptr, 0);
+}
+
+PartitionedConvolution::~PartitionedConvolution() = default;
+
+void PartitionedConvolution::setImpulseResponse (const float* impulseResponse, int length)
+{
+    impulseResponseLength = length;
+
+    head.assign (static_cast<size_t> (headLength), 0.0f);
+    for (int i = 0; i < juce::jmin (length, headLength); ++i)
+        head[static_cast<size_t> (headLength - 1 - i)] = impulseResponse[i];
+
+    // Each partition size may start once the offset reaches it, so the sizes
+    // grow 64 → 256 → 1024 → 4096 after three partitions each
+    segments.clear();
+    int offset = headLength, size = headLength, span = headLength;
+
+    while (offset < length)
+    {
+        auto nextSize = juce::jmin (size * 4, maximumPartitionSize);
+        auto end = nextSize > size ? juce::jmin (nextSize, length) : length;
+        auto count = (end - offset + size - 1) / size;
+
+        segments.push_back (std::make_unique<Segment> (size, offset, count,
+                                                       std::make_shared<const Segment::Kernel> (size, count, impulseResponse + offset,
+                                                                                                length - offset)));
+        span = juce::jmax (span, offset + size);
+
+        offset += count * size;
+        size = nextSize;
+    }
+
+    accumulator.resize (static_cast<size_t> (juce::nextPowerOfTwo (span + headLength)));
+    accumulatorMask = accumulator.size() - 1;
+
+    history.resize (static_cast<size_t> (2 * headLength));
+    reset();
+}
+
+void PartitionedConvolution::shareImpulseResponse (const PartitionedConvolution& other)
+{
+    impulseResponseLength = other.impulseResponseLength;
+    head = other.head;
+
+    segments.clear();
+
+    for (auto& segment : other.segments)
+        segments.push_back (std::make_unique<Segment> (segment->partitionSize, segment->offset,
+                                                       segment->numPartitions, segment->kernel));
+
+    accumulator.resize (other.accumulator.size());
+    accumulatorMask = other.accumulatorMask;
+
+    history.resize (static_cast<size_t> (2 * headLength));
+    reset();
+}
+
+void PartitionedConvolution::reset() noexcept
+{
+    std::fill (history.begin(), history.end(), 0.0f);
+    std::fill (accumulator.begin(), accumulator.end(), 0.0f);
+    historyPosition = 0;
+    time = 0;
+
+    for (auto& segment : segments)
+        segment->reset();
+}
+
+void PartitionedConvolution::process (const float* input, float* output, int numSamples) noexcept
+{
+    while (numSamples > 0)
+    {
+        // Work up to the next headLength boundary, where segments may complete
+        auto phase = static_cast<int> (time % static_cast<size_t> (headLength));
+        auto count = juce::jmin (numSamples, headLength - phase);
+
+        // Copy the input first: output may overwrite it
+        for (auto& segment : segments)
+        {
+            std::copy (input, input + count, segment->input.begin() + segment->partitionSize + segment->fill);
+            segment->fill += count;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            history[static_cast<size_t> (historyPosition)] = input[i];
+            history[static_cast<size_t> (historyPosition + headLength)] = input[i];
+            historyPosition = (historyPosition + 1) & (headLength - 1);
+
+            // Direct-form head over the last headLength inputs, oldest first
+            auto* window = history.data() + historyPosition;
+            float y = 0.0f;
+
+            for (int j = 0; j < headLength; ++j)
+                y += head[static_cast<size_t> (j)] * window[j];
+
+            auto& pending = accumulator[(time + static_cast<size_t> (i)) & accumulatorMask];
+            output[i] = y + pending;
+            pending = 0.0f;
+        }
+
+        time += static_cast<size_t> (count);
+        input += count;
+        output += count;
+        numSamples -= count;
+
+        for (auto& segment : segments)
+        {
+            if (segment->fill < segment->partitionSize)
+                continue;
+
+            // Results start offset samples after the partition's first input,
+            // which is never earlier than now (offset >= partitionSize)
+            auto* result = segment->run();
+            auto start = time - static_cast<size_t> (segment->partitionSize) + static_cast<size_t> (segment->offset);
+
+            for (int i = 0; i < segment->partitionSize; ++i)
+                accumulator[(start + static_cast<size_t> (i)) & accumulatorMask] += result[i];
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    Zero-latency mono convolution with non-uniform partitions.
+
+    The first headLength taps run as a direct-form FIR, so output never waits
+    for an FFT block. The rest of the IR is cut into segments whose partition
+    size grows by 4x (64, 256, 1024, then 4096 until the end). A segment
+    starting at offset n only needs partitions of up to n samples to finish in
+    time, so each one runs a uniformly partitioned overlap-save convolution
+    (frequency-domain delay line) whose results land in an output accumulator
+    ahead of the playhead. Long IRs therefore cost mostly large, cheap FFTs
+    and add no latency.
+
+    Every FFT runs synchronously inside process(), so blocks where several
+    segments complete at once take longer than average.
+*/
+class PartitionedConvolution
+{
+public:
+    //==============================================================================
+    static constexpr int headLength = 64;             // Direct-form taps and smallest partition
+    static constexpr int maximumPartitionSize = 4096;
+
+    PartitionedConvolution();
+    ~PartitionedConvolution();
+
+    /** Builds the partitions for an IR and clears the state. Not realtime safe. */
+    void setImpulseResponse (const float* impulseResponse, int length);
+
+    /** Convolves with the same IR as another instance, sharing its partition
+        spectra instead of building them again, and clears the state. Only the
+        convolution state is this instance's own. Not realtime safe.
+    */
+    void shareImpulseResponse (const PartitionedConvolution& other);
+
+    int getImpulseResponseLength() const noexcept   { return impulseResponseLength; }
+
+    /** Clears the convolution state. */
+    void reset() noexcept;
+
+    /** Convolves numSamples samples. input and output may be the same. */
+    void process (const float* input, float* output, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    struct Segment;
+
+    std::vector<std::unique_ptr<Segment>> segments;
+
+    // Head: IR taps reversed, and input history written twice so the last
+    // headLength samples are always contiguous
+    std::vector<float> head, history;
+    int historyPosition = 0;
+
+    // Segment outputs, indexed by absolute sample time
+    std::vector<float> accumulator;
+    size_t accumulatorMask = 0;
+
+    size_t time = 0;
+    int impulseResponseLength = 0;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PartitionedConvolution)
+};
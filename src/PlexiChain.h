@@ -0,0 +1,287 @@
+#pragma once
+
+#include "PlexiStages.h"
+#include "TubeShaper.h"
+
+//==============================================================================
+namespace PlexiVoicing
+{
+    /** Channel and link settings. The processor runs a chain per voicing, each
+        with its own channel filter (the chains are otherwise the same).
+    */
+    enum class Voicing
+    {
+        normal,
+        bright,
+        link
+    };
+
+    inline Voicing getVoicing (int channel, bool link) noexcept
+    {
+        if (link)
+            return Voicing::link;
+
+        return channel == 0 ? Voicing::normal : Voicing::bright;
+    }
+}
+
+//==============================================================================
+/**
+    Marshall Plexi amp modeling chain.
+
+    Instantiated for float (one channel) and for SIMDRegister<float> with one
+    channel or amp instance per lane. ClaudeAmpProcessor and AmpBank both build
+    their chains and map their parameters through PlexiVoicing, so the same
+    settings give the same samples whichever of them runs the amp.
+*/
+template <typename SampleType>
+using PlexiChain = juce::dsp::ProcessorChain<
+    PlexiStages::Gain<SampleType>,          // 0: Input level (controlled by Drive)
+    PlexiStages::HighPass<SampleType>,      // 1: Channel brightness (Normal=10Hz, Bright=285Hz, Link=150Hz HPF)
+    PlexiStages::Biquad<SampleType>,        // 2: Pre-emphasis (+6dB @ 5kHz)
+    TubeShaper,                             // 3: Preamp stage 1 (12AX7, bias folded in)
+    PlexiStages::HighPass<SampleType>,      // 4: Coupling HPF 1
+    TubeShaper,                             // 5: Preamp stage 2 (12AX7, bias folded in)
+    PlexiStages::HighPass<SampleType>,      // 6: Coupling HPF 2
+    TubeShaper,                             // 7: Preamp stage 3 (12AX7, bias folded in)
+    PlexiStages::Biquad<SampleType>,        // 8: De-emphasis (-6dB @ 5kHz)
+    PlexiStages::ToneStack<SampleType>,     // 9: Tone stack (passive bass/mid/treble network)
+    PlexiStages::PowerStage<SampleType>,    // 10: Power amp (EL34) with power supply sag
+    PlexiStages::Biquad<SampleType>,        // 11: Presence (high-shelf boost)
+    PlexiStages::DcBlocker<SampleType>,     // 12: DC blocker
+    PlexiStages::Gain<SampleType>           // 13: Master volume
+>;
+
+//==============================================================================
+namespace PlexiVoicing
+{
+    /** Control smoothing: 5ms ramps, and while any control ramps the gains and
+        coefficients are updated every this many input samples.
+    */
+    constexpr double smoothingSeconds = 0.005;
+    constexpr int smoothingChunkSize = 32;
+
+    /** Builds the tube tables. Each folds the stage gain and the bias offset in
+        front of it into one lookup. Not realtime safe (allocates).
+    */
+    template <typename Chain>
+    void initialiseTubeStages (Chain& chain)
+    {
+        // Preamp stage 1: 12AX7 with ~35dB gain, asymmetric bias 0.3
+        // Real 12AX7: μ=100, practical gain 30-60x in circuit
+        chain.template get<3>().initialise (TubeShaper::preampStage1, 0.3f);
+
+        // Preamp stage 2: more gain, harder clipping, bias 0.35
+        chain.template get<5>().initialise (TubeShaper::preampStage2, 0.35f);
+
+        // Preamp stage 3: heaviest saturation, bias 0.4
+        chain.template get<7>().initialise (TubeShaper::preampStage3, 0.4f);
+
+        // Power amp: EL34 push-pull, more symmetrical than 12AX7, no bias
+        chain.template get<10>().initialise (TubeShaper::powerAmp, 0.0f);
+    }
+
+    /** Delay of the antiderivative tube stages, in samples at the chain's rate:
+        half a sample for each of the four.
+    */
+    constexpr int antiderivativeDelaySamples = 2;
+
+    /** Switches every tube stage between the plain table and antiderivative
+        anti-aliasing (see TubeShaper). Call when the chain is not running.
+    */
+    template <typename Chain>
+    void setAntiderivativeTubes (Chain& chain, bool antiderivative) noexcept
+    {
+        chain.template get<3>().setAntiderivative (antiderivative);
+        chain.template get<5>().setAntiderivative (antiderivative);
+        chain.template get<7>().setAntiderivative (antiderivative);
+        chain.template get<10>().setAntiderivative (antiderivative);
+    }
+
+    /** Tube stages whose clipping can be counted: the three preamp stages and the power amp. */
+    constexpr int numTubeStages = 4;
+
+    /** Switches clipped-sample counting on every tube stage (see TubeShaper). */
+    template <typename Chain>
+    void setClipCounting (Chain& chain, bool counting) noexcept
+    {
+        chain.template get<3>().setClipCounting (counting);
+        chain.template get<5>().setClipCounting (counting);
+        chain.template get<7>().setClipCounting (counting);
+        chain.template get<10>().setClipCounting (counting);
+    }
+
+    /** Adds each tube stage's clipped samples in the first numLanes lanes
+        since the last call to counts (the other lanes' counts are dropped).
+    */
+    template <typename Chain>
+    void takeClippedSamples (Chain& chain, size_t numLanes, int (&counts)[numTubeStages]) noexcept
+    {
+        counts[0] += chain.template get<3>().takeClippedSamples (numLanes);
+        counts[1] += chain.template get<5>().takeClippedSamples (numLanes);
+        counts[2] += chain.template get<7>().takeClippedSamples (numLanes);
+        counts[3] += chain.template get<10>().takeClippedSamples (numLanes);
+    }
+
+    /** Settings that never change with the controls. Call after chain.prepare(). */
+    template <typename Chain>
+    void configureFixedStages (Chain& chain)
+    {
+        // Stage 0: Input gain (controlled by Drive parameter)
+        chain.template get<0>().setGainDecibels (0.0f);
+
+        // Stages 4 and 6: Coupling capacitor HPFs (~20 Hz)
+        chain.template get<4>().setCutoffFrequency (20.0f);
+        chain.template get<4>().setResonance (0.707f);
+        chain.template get<6>().setCutoffFrequency (20.0f);
+        chain.template get<6>().setResonance (0.707f);
+
+        // Stage 12: DC blocker
+        chain.template get<12>().setCutoffFrequency (5.0f);
+    }
+
+    // processPreamp() with the tube kernels (table or antiderivative) from getTubeKernel
+    template <typename Chain, typename SampleType, typename GetTubeKernel>
+    void processPreamp (Chain& chain, const juce::dsp::AudioBlock<SampleType>& block, GetTubeKernel&& getTubeKernel) noexcept
+    {
+        jassert (block.getNumChannels() == 1);
+
+        auto preEmphasis = chain.template get<2>().getKernel();
+        auto tube1       = getTubeKernel (chain.template get<3>());
+        auto coupling1   = chain.template get<4>().getKernel();
+        auto tube2       = getTubeKernel (chain.template get<5>());
+        auto coupling2   = chain.template get<6>().getKernel();
+        auto tube3       = getTubeKernel (chain.template get<7>());
+        auto deEmphasis  = chain.template get<8>().getKernel();
+        auto toneStack   = chain.template get<9>().getKernel();
+
+        auto* data = block.getChannelPointer (0);
+
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+        {
+            auto x = preEmphasis.processSample (data[i]);
+            x = coupling1.processSample (tube1.processSample (x));
+            x = coupling2.processSample (tube2.processSample (x));
+            x = deEmphasis.processSample (tube3.processSample (x));
+            data[i] = toneStack.processSample (x);
+        }
+
+        chain.template get<2>().setState (preEmphasis);
+        chain.template get<3>().setState (tube1);
+        chain.template get<4>().setState (coupling1);
+        chain.template get<5>().setState (tube2);
+        chain.template get<6>().setState (coupling2);
+        chain.template get<7>().setState (tube3);
+        chain.template get<8>().setState (deEmphasis);
+        chain.template get<9>().setState (toneStack);
+    }
+
+    /** Runs stages 2-9 (pre-emphasis, the three preamp tubes with their
+        coupling filters, de-emphasis and the tone stack) in place as one fused
+        per-sample loop. Every coefficient and state lives in a local for the
+        whole block, so the oversampled block is read and written once instead
+        of once per stage. Same samples as running the stages one by one.
+    */
+    template <typename Chain, typename SampleType>
+    void processPreamp (Chain& chain, const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        // The tube modes are set for all stages at once (setAntiderivativeTubes, setClipCounting)
+        auto& firstTube = chain.template get<3>();
+
+        if (firstTube.countsClipping())
+        {
+            if (firstTube.usesAntiderivative())
+                processPreamp (chain, block, [] (const TubeShaper& tube)
+                               { return tube.getClipCountingKernel<SampleType> (tube.getAntiderivativeKernel<SampleType>()); });
+            else
+                processPreamp (chain, block, [] (const TubeShaper& tube) { return tube.getClipCountingKernel<SampleType> (tube.getKernel()); });
+        }
+        else if (firstTube.usesAntiderivative())
+        {
+            processPreamp (chain, block, [] (const TubeShaper& tube) { return tube.getAntiderivativeKernel<SampleType>(); });
+        }
+        else
+        {
+            processPreamp (chain, block, [] (const TubeShaper& tube) { return tube.getKernel(); });
+        }
+    }
+
+    /** Runs the whole chain in place, with the preamp fused (see processPreamp).
+        Gives the same samples as chain.process(). Stage bypass is not supported.
+    */
+    template <typename Chain, typename SampleType>
+    void process (Chain& chain, const juce::dsp::ProcessContextReplacing<SampleType>& context) noexcept
+    {
+        jassert (! context.isBypassed);
+
+        chain.template get<0>().process (context);
+        chain.template get<1>().process (context);
+        processPreamp (chain, context.getOutputBlock());
+        chain.template get<10>().process (context);
+        chain.template get<11>().process (context);
+        chain.template get<12>().process (context);
+        chain.template get<13>().process (context);
+    }
+
+    /** Stage 2: Pre-emphasis (+6 dB @ 5 kHz before saturation). */
+    inline juce::dsp::IIR::Coefficients<float>::Ptr makePreEmphasis (double oversampledRate)
+    {
+        return juce::dsp::IIR::Coefficients<float>::makeHighShelf (oversampledRate, 5000.0f, 0.707f, 1.995f);  // +6 dB
+    }
+
+    /** Stage 8: De-emphasis (-6 dB @ 5 kHz after saturation). */
+    inline juce::dsp::IIR::Coefficients<float>::Ptr makeDeEmphasis (double oversampledRate)
+    {
+        return juce::dsp::IIR::Coefficients<float>::makeHighShelf (oversampledRate, 5000.0f, 0.707f, 0.501f);  // -6 dB
+    }
+
+    //==============================================================================
+    /** Stage 1: Channel brightness filter.
+
+        Simulates different cathode bypass capacitor values in real Plexi:
+        Normal: 330µF (full-range gain, thicker bass; still keeps DC and
+                sub-audio out of the asymmetric tube stages)
+        Bright: 0.68µF (gain rolloff below 285Hz, more aggressive/crunchy)
+    */
+    struct ChannelFilter
+    {
+        float cutoffHz;
+        float resonance;
+    };
+
+    inline ChannelFilter getChannelFilter (Voicing voicing) noexcept
+    {
+        switch (voicing)
+        {
+            case Voicing::link:    return { 150.0f, 0.5f };   // Blend approximates Normal + Bright (jumper cable trick)
+            case Voicing::bright:  return { 285.0f, 0.6f };   // Rolloff below 285Hz (authentic), slightly peaky for "bright" character
+            case Voicing::normal:  break;
+        }
+
+        return { 10.0f, 0.707f };                              // Full-range, thick bass
+    }
+
+    /** Sets up stage 1 of a chain variant for its voicing. Call after chain.prepare(). */
+    template <Voicing voicing, typename Chain>
+    void configureChannelStage (Chain& chain)
+    {
+        auto channelFilter = getChannelFilter (voicing);
+        chain.template get<1>().setCutoffFrequency (channelFilter.cutoffHz);
+        chain.template get<1>().setResonance (channelFilter.resonance);
+    }
+
+    /** Stage 0: Input level from Drive.
+        Real Plexi has 60-90dB total preamp gain (3 stages @ 30-40dB each);
+        Drive controls the input level feeding the cascaded gain stages.
+    */
+    inline float getInputGainDecibels (float drive) noexcept
+    {
+        return drive * 6.0f;  // 0→0dB, 5→30dB, 10→60dB
+    }
+
+    /** Stage 13: Master volume (0-10 → -20 to +20 dB). */
+    inline float getMasterGainDecibels (float master) noexcept
+    {
+        return -20.0f + (master * 4.0f);  // 0→-20dB, 5→0dB, 10→+20dB
+    }
+}
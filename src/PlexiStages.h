@@ -0,0 +1,786 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "TubeShaper.h"
+
+#if ! JUCE_USE_SIMD
+ #error "ClaudeAmp's channel-parallel amp chain needs juce::dsp::SIMDRegister (SSE, AVX or NEON)"
+#endif
+
+//==============================================================================
+/**
+    Amp chain stages that run on either float or juce::dsp::SIMDRegister<float>.
+
+    With SIMDRegister samples, every lane carries one channel of the
+    interleaved oversampled signal, so each vector operation advances all
+    channels at once. The float versions are used for mono. Both apply the
+    same operations in the same order, so a lane of the vector chain computes
+    exactly what the scalar chain computes for that channel.
+
+    Each processor expects a single-channel block (the interleaved stream, or
+    the mono channel) and keeps one state value of SampleType per filter.
+    Equations match the juce::dsp classes they replace: Gain (no ramp),
+    StateVariableTPTFilter (highpass), FirstOrderTPTFilter (highpass) and
+    IIR::Filter (second order); ToneStack has no JUCE counterpart. Owning the
+    state lets copyChainLane() move a channel between the mono and the vector
+    chain without a discontinuity.
+
+    Coefficients are held as SampleType too. The plain setters broadcast one
+    setting to every lane; the lane setters give each lane its own, which is
+    how AmpBank runs a different amp in every lane.
+*/
+namespace PlexiStages
+{
+    //==============================================================================
+    inline float getLane (float value, size_t) noexcept                                       { return value; }
+    inline float getLane (juce::dsp::SIMDRegister<float> value, size_t lane) noexcept         { return value.get (lane); }
+
+    inline void setLane (float& value, size_t, float newValue) noexcept                       { value = newValue; }
+    inline void setLane (juce::dsp::SIMDRegister<float>& value, size_t lane, float newValue) noexcept  { value.set (lane, newValue); }
+
+    inline float getAbsolute (float value) noexcept                                           { return std::abs (value); }
+    inline juce::dsp::SIMDRegister<float> getAbsolute (juce::dsp::SIMDRegister<float> value) noexcept  { return juce::dsp::SIMDRegister<float>::abs (value); }
+
+    /** Per lane: a > b ? ifGreater : otherwise. */
+    inline float selectGreater (float a, float b, float ifGreater, float otherwise) noexcept
+    {
+        return a > b ? ifGreater : otherwise;
+    }
+
+    inline juce::dsp::SIMDRegister<float> selectGreater (juce::dsp::SIMDRegister<float> a, juce::dsp::SIMDRegister<float> b,
+                                                         juce::dsp::SIMDRegister<float> ifGreater,
+                                                         juce::dsp::SIMDRegister<float> otherwise) noexcept
+    {
+        auto greater = juce::dsp::SIMDRegister<float>::greaterThan (a, b);
+        return (ifGreater & greater) + (otherwise & ~greater);
+    }
+
+    //==============================================================================
+    /** Static gain (juce::dsp::Gain with no ramp). */
+    template <typename SampleType>
+    class Gain
+    {
+    public:
+        void setGainDecibels (float newGainDecibels) noexcept                { gain = SampleType (juce::Decibels::decibelsToGain (newGainDecibels)); }
+        void setGainDecibels (size_t lane, float newGainDecibels) noexcept   { setLane (gain, lane, juce::Decibels::decibelsToGain (newGainDecibels)); }
+        void setGainLinear (float newGain) noexcept                          { gain = SampleType (newGain); }
+
+        void prepare (const juce::dsp::ProcessSpec&) noexcept   {}
+        void reset() noexcept                                    {}
+
+        template <typename ProcessContext>
+        void process (const ProcessContext& context) noexcept
+        {
+            auto&& inputBlock  = context.getInputBlock();
+            auto&& outputBlock = context.getOutputBlock();
+
+            jassert (inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+            if (context.isBypassed)
+            {
+                if (context.usesSeparateInputAndOutputBlocks())
+                    outputBlock.copyFrom (inputBlock);
+
+                return;
+            }
+
+            auto* input  = inputBlock.getChannelPointer (0);
+            auto* output = outputBlock.getChannelPointer (0);
+
+            for (size_t i = 0; i < outputBlock.getNumSamples(); ++i)
+                output[i] = input[i] * gain;
+        }
+
+    private:
+        SampleType gain { 1.0f };
+    };
+
+    //==============================================================================
+    /** TPT state variable highpass (juce::dsp::StateVariableTPTFilter, highpass output). */
+    template <typename SampleType>
+    class HighPass
+    {
+    public:
+        void setCutoffFrequency (float newCutoffHz) noexcept
+        {
+            if (newCutoffHz != cutoffFrequency)
+            {
+                cutoffFrequency = newCutoffHz;
+                update();
+            }
+        }
+
+        void setResonance (float newResonance) noexcept
+        {
+            if (newResonance != resonance)
+            {
+                resonance = newResonance;
+                update();
+            }
+        }
+
+        /** Sets the cutoff and resonance of a single lane. */
+        void setParameters (size_t lane, float cutoffHz, float laneResonance) noexcept
+        {
+            float laneG, laneR2, laneH;
+            calculateCoefficients (cutoffHz, laneResonance, laneG, laneR2, laneH);
+
+            setLane (g, lane, laneG);
+            setLane (R2, lane, laneR2);
+            setLane (h, lane, laneH);
+        }
+
+        void prepare (const juce::dsp::ProcessSpec& spec) noexcept
+        {
+            sampleRate = spec.sampleRate;
+            update();
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            s1 = SampleType (0.0f);
+            s2 = SampleType (0.0f);
+        }
+
+        /** Coefficients and state as locals, for loops that run several stages per sample. */
+        struct Kernel
+        {
+            SampleType g, R2, h;
+            SampleType s1, s2;
+
+            SampleType processSample (SampleType x) noexcept
+            {
+                auto yHP = (x - s1 * (g + R2) - s2) * h;
+
+                auto yBP = yHP * g + s1;
+                s1       = yHP * g + yBP;
+
+                auto yLP = yBP * g + s2;
+                s2       = yBP * g + yLP;
+
+                return yHP;
+            }
+        };
+
+        Kernel getKernel() const noexcept               { return { g, R2, h, s1, s2 }; }
+        void setState (const Kernel& kernel) noexcept   { s1 = kernel.s1; s2 = kernel.s2; }
+
+        template <typename OtherSampleType>
+        void copyLaneFrom (const HighPass<OtherSampleType>& source, size_t sourceLane, size_t destinationLane) noexcept
+        {
+            setLane (s1, destinationLane, getLane (source.s1, sourceLane));
+            setLane (s2, destinationLane, getLane (source.s2, sourceLane));
+        }
+
+        template <typename ProcessContext>
+        void process (const ProcessContext& context) noexcept
+        {
+            auto&& inputBlock  = context.getInputBlock();
+            auto&& outputBlock = context.getOutputBlock();
+
+            jassert (inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+            if (context.isBypassed)
+            {
+                if (context.usesSeparateInputAndOutputBlocks())
+                    outputBlock.copyFrom (inputBlock);
+
+                return;
+            }
+
+            auto* input  = inputBlock.getChannelPointer (0);
+            auto* output = outputBlock.getChannelPointer (0);
+            auto kernel = getKernel();
+
+            for (size_t i = 0; i < outputBlock.getNumSamples(); ++i)
+                output[i] = kernel.processSample (input[i]);
+
+            setState (kernel);
+        }
+
+    private:
+        template <typename> friend class HighPass;
+
+        void update() noexcept
+        {
+            if (sampleRate <= 0.0)
+                return;
+
+            float newG, newR2, newH;
+            calculateCoefficients (cutoffFrequency, resonance, newG, newR2, newH);
+
+            g  = SampleType (newG);
+            R2 = SampleType (newR2);
+            h  = SampleType (newH);
+        }
+
+        void calculateCoefficients (float cutoffHz, float q, float& newG, float& newR2, float& newH) const noexcept
+        {
+            jassert (sampleRate > 0.0);
+
+            newG  = static_cast<float> (std::tan (juce::MathConstants<double>::pi * cutoffHz / sampleRate));
+            newR2 = static_cast<float> (1.0 / q);
+            newH  = static_cast<float> (1.0 / (1.0 + newR2 * newG + newG * newG));
+        }
+
+        SampleType s1 { 0.0f }, s2 { 0.0f };
+        SampleType g { 0.0f }, h { 0.0f }, R2 { 0.0f };
+        float cutoffFrequency = 1000.0f, resonance = 1.0f / juce::MathConstants<float>::sqrt2;
+        double sampleRate = 0.0;
+    };
+
+    //==============================================================================
+    /** First-order TPT highpass (juce::dsp::FirstOrderTPTFilter, highpass output). */
+    template <typename SampleType>
+    class DcBlocker
+    {
+    public:
+        void setCutoffFrequency (float newCutoffHz) noexcept
+        {
+            cutoffFrequency = newCutoffHz;
+            update();
+        }
+
+        void prepare (const juce::dsp::ProcessSpec& spec) noexcept
+        {
+            sampleRate = spec.sampleRate;
+            update();
+            reset();
+        }
+
+        void reset() noexcept   { s = SampleType (0.0f); }
+
+        SampleType processSample (SampleType x) noexcept
+        {
+            auto v = (x - s) * G;
+            auto y = v + s;
+            s = y + v;
+
+            return x - y;
+        }
+
+        template <typename OtherSampleType>
+        void copyLaneFrom (const DcBlocker<OtherSampleType>& source, size_t sourceLane, size_t destinationLane) noexcept
+        {
+            setLane (s, destinationLane, getLane (source.s, sourceLane));
+        }
+
+        template <typename ProcessContext>
+        void process (const ProcessContext& context) noexcept
+        {
+            auto&& inputBlock  = context.getInputBlock();
+            auto&& outputBlock = context.getOutputBlock();
+
+            jassert (inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+            if (context.isBypassed)
+            {
+                if (context.usesSeparateInputAndOutputBlocks())
+                    outputBlock.copyFrom (inputBlock);
+
+                return;
+            }
+
+            auto* input  = inputBlock.getChannelPointer (0);
+            auto* output = outputBlock.getChannelPointer (0);
+
+            for (size_t i = 0; i < outputBlock.getNumSamples(); ++i)
+                output[i] = processSample (input[i]);
+        }
+
+    private:
+        template <typename> friend class DcBlocker;
+
+        void update() noexcept
+        {
+            if (sampleRate <= 0.0)
+                return;
+
+            auto g = std::tan (juce::MathConstants<double>::pi * cutoffFrequency / sampleRate);
+            G = static_cast<float> (g / (1.0 + g));
+        }
+
+        SampleType s { 0.0f };
+        float G = 0.0f;
+        float cutoffFrequency = 1000.0f;
+        double sampleRate = 0.0;
+    };
+
+    //==============================================================================
+    /** Second-order IIR, transposed direct form II (juce::dsp::IIR::Filter).
+
+        Reads the normalised coefficients from a shared juce::dsp::IIR::Coefficients
+        object at the start of every block, so in-place coefficient updates are
+        picked up without touching the filter. Without a shared object, the
+        per-lane coefficients from setCoefficients() are used instead.
+    */
+    template <typename SampleType>
+    class Biquad
+    {
+    public:
+        juce::dsp::IIR::Coefficients<float>::Ptr coefficients;
+
+        /** Sets one lane's normalised {b0, b1, b2, a1, a2}. */
+        void setCoefficients (size_t lane, const float* normalisedCoefficients) noexcept
+        {
+            jassert (coefficients == nullptr);
+
+            for (size_t i = 0; i < 5; ++i)
+                setLane (laneCoefficients[i], lane, normalisedCoefficients[i]);
+        }
+
+        void prepare (const juce::dsp::ProcessSpec&) noexcept   { reset(); }
+
+        void reset() noexcept
+        {
+            s1 = SampleType (0.0f);
+            s2 = SampleType (0.0f);
+        }
+
+        /** Coefficients and state as locals, for loops that run several stages
+            per sample. Takes the coefficients in effect now, like a new block.
+        */
+        struct Kernel
+        {
+            SampleType b0, b1, b2, a1, a2;  // Already divided by a0
+            SampleType s1, s2;
+
+            SampleType processSample (SampleType x) noexcept
+            {
+                auto y = x * b0 + s1;
+                s1 = x * b1 - y * a1 + s2;
+                s2 = x * b2 - y * a2;
+                return y;
+            }
+        };
+
+        Kernel getKernel() const noexcept
+        {
+            jassert (coefficients == nullptr || coefficients->getFilterOrder() == 2);
+
+            if (coefficients != nullptr)
+            {
+                const auto* c = coefficients->getRawCoefficients();
+                return { SampleType (c[0]), SampleType (c[1]), SampleType (c[2]), SampleType (c[3]), SampleType (c[4]), s1, s2 };
+            }
+
+            return { laneCoefficients[0], laneCoefficients[1], laneCoefficients[2],
+                     laneCoefficients[3], laneCoefficients[4], s1, s2 };
+        }
+
+        void setState (const Kernel& kernel) noexcept   { s1 = kernel.s1; s2 = kernel.s2; }
+
+        template <typename OtherSampleType>
+        void copyLaneFrom (const Biquad<OtherSampleType>& source, size_t sourceLane, size_t destinationLane) noexcept
+        {
+            setLane (s1, destinationLane, getLane (source.s1, sourceLane));
+            setLane (s2, destinationLane, getLane (source.s2, sourceLane));
+        }
+
+        template <typename ProcessContext>
+        void process (const ProcessContext& context) noexcept
+        {
+            auto&& inputBlock  = context.getInputBlock();
+            auto&& outputBlock = context.getOutputBlock();
+
+            jassert (inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+            if (context.isBypassed)
+            {
+                if (context.usesSeparateInputAndOutputBlocks())
+                    outputBlock.copyFrom (inputBlock);
+
+                return;
+            }
+
+            auto* input  = inputBlock.getChannelPointer (0);
+            auto* output = outputBlock.getChannelPointer (0);
+            auto kernel = getKernel();
+
+            for (size_t i = 0; i < outputBlock.getNumSamples(); ++i)
+                output[i] = kernel.processSample (input[i]);
+
+            setState (kernel);
+        }
+
+    private:
+        template <typename> friend class Biquad;
+
+        SampleType s1 { 0.0f }, s2 { 0.0f };
+        SampleType laneCoefficients[5] { SampleType (1.0f), SampleType (0.0f), SampleType (0.0f),
+                                         SampleType (0.0f), SampleType (0.0f) };
+    };
+
+    //==============================================================================
+    /** Passive tone stack as one third-order filter: a direct path plus three
+        first-order sections in parallel, all fed from the same input.
+
+        Coefficients are {d, g1, p1, g2, p2, g3, p3} (ToneStackModel
+        designs them), and each section computes y = g (x + x[n-1]) + p y[n-1].
+        Like Biquad, it reads a shared coefficient array at the start of every
+        block if one is set, and its per-lane coefficients otherwise.
+    */
+    template <typename SampleType>
+    class ToneStack
+    {
+    public:
+        static constexpr size_t numCoefficients = 7;
+
+        /** Shared coefficients, updated in place by the owner (or nullptr). */
+        const float* coefficients = nullptr;
+
+        /** Sets one lane's coefficients. */
+        void setCoefficients (size_t lane, const float* newCoefficients) noexcept
+        {
+            jassert (coefficients == nullptr);
+
+            for (size_t i = 0; i < numCoefficients; ++i)
+                setLane (laneCoefficients[i], lane, newCoefficients[i]);
+        }
+
+        void prepare (const juce::dsp::ProcessSpec&) noexcept   { reset(); }
+
+        void reset() noexcept
+        {
+            x1 = SampleType (0.0f);
+
+            for (auto& y : sections)
+                y = SampleType (0.0f);
+        }
+
+        /** Coefficients and state as locals, for loops that run several stages
+            per sample. Takes the coefficients in effect now, like a new block.
+        */
+        struct Kernel
+        {
+            SampleType d, g1, p1, g2, p2, g3, p3;
+            SampleType x1, y1, y2, y3;
+
+            SampleType processSample (SampleType x) noexcept
+            {
+                auto u = x + x1;
+                x1 = x;
+                y1 = g1 * u + p1 * y1;
+                y2 = g2 * u + p2 * y2;
+                y3 = g3 * u + p3 * y3;
+                return d * x + y1 + y2 + y3;
+            }
+        };
+
+        Kernel getKernel() const noexcept
+        {
+            if (coefficients != nullptr)
+            {
+                const auto* c = coefficients;
+                return { SampleType (c[0]), SampleType (c[1]), SampleType (c[2]), SampleType (c[3]),
+                         SampleType (c[4]), SampleType (c[5]), SampleType (c[6]),
+                         x1, sections[0], sections[1], sections[2] };
+            }
+
+            const auto* c = laneCoefficients;
+            return { c[0], c[1], c[2], c[3], c[4], c[5], c[6], x1, sections[0], sections[1], sections[2] };
+        }
+
+        void setState (const Kernel& kernel) noexcept
+        {
+            x1 = kernel.x1;
+            sections[0] = kernel.y1;
+            sections[1] = kernel.y2;
+            sections[2] = kernel.y3;
+        }
+
+        template <typename OtherSampleType>
+        void copyLaneFrom (const ToneStack<OtherSampleType>& source, size_t sourceLane, size_t destinationLane) noexcept
+        {
+            setLane (x1, destinationLane, getLane (source.x1, sourceLane));
+
+            for (size_t i = 0; i < 3; ++i)
+                setLane (sections[i], destinationLane, getLane (source.sections[i], sourceLane));
+        }
+
+        template <typename ProcessContext>
+        void process (const ProcessContext& context) noexcept
+        {
+            auto&& inputBlock  = context.getInputBlock();
+            auto&& outputBlock = context.getOutputBlock();
+
+            jassert (inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+            if (context.isBypassed)
+            {
+                if (context.usesSeparateInputAndOutputBlocks())
+                    outputBlock.copyFrom (inputBlock);
+
+                return;
+            }
+
+            auto* input  = inputBlock.getChannelPointer (0);
+            auto* output = outputBlock.getChannelPointer (0);
+            auto kernel = getKernel();
+
+            for (size_t i = 0; i < outputBlock.getNumSamples(); ++i)
+                output[i] = kernel.processSample (input[i]);
+
+            setState (kernel);
+        }
+
+    private:
+        template <typename> friend class ToneStack;
+
+        SampleType x1 { 0.0f };
+        SampleType sections[3] { SampleType (0.0f), SampleType (0.0f), SampleType (0.0f) };
+
+        // Identity until set: direct path only
+        SampleType laneCoefficients[numCoefficients] { SampleType (1.0f), SampleType (0.0f), SampleType (0.0f),
+                                                       SampleType (0.0f), SampleType (0.0f), SampleType (0.0f),
+                                                       SampleType (0.0f) };
+    };
+
+    //==============================================================================
+    /** Power amp tubes with power supply sag.
+
+        A per-sample attack/release follower on the rectified drive signal
+        stands in for the B+ rail. As the envelope rises the rail drops (by up
+        to maximumSagDecibels) and the tubes lose headroom: the input is scaled
+        by 1/rail ahead of the tube curve and the output by rail, so the stage
+        compresses and breaks up earlier under load. Time constants are in
+        milliseconds of the running (oversampled) rate, and the rail is
+        recomputed on a grid of railUpdateInterval samples that carries over
+        between blocks, so the result does not depend on the block size.
+    */
+    template <typename SampleType>
+    class PowerStage
+    {
+    public:
+        static constexpr double attackMilliseconds = 20.0;    // Filter caps draining under load
+        static constexpr double releaseMilliseconds = 250.0;  // Recharging through the rectifier
+        static constexpr float maximumSagDecibels = 3.2f;
+        static constexpr float sagSensitivity = 1.5f;         // Envelope scale into the tanh knee
+        static constexpr int railUpdateInterval = 32;         // Samples; rail ramps linearly in between
+
+        /** Builds the tube table (see TubeShaper::initialise). Not realtime safe. */
+        void initialise (const TubeShaper::Curve& curve, float bias)   { shaper.initialise (curve, bias); }
+
+        /** See TubeShaper::setAntiderivative. */
+        void setAntiderivative (bool shouldUseAntiderivative) noexcept  { shaper.setAntiderivative (shouldUseAntiderivative); }
+
+        /** See TubeShaper::setClipCounting. */
+        void setClipCounting (bool shouldCount) noexcept   { shaper.setClipCounting (shouldCount); }
+        int takeClippedSamples (size_t numLanes) noexcept  { return shaper.takeClippedSamples (numLanes); }
+
+        /** Headroom the sag currently takes away, in dB (the most of any lane). */
+        float getSagDecibels() const noexcept
+        {
+            auto lowestRail = 1.0f;
+
+            for (size_t lane = 0; lane < sizeof (SampleType) / sizeof (float); ++lane)
+                lowestRail = juce::jmin (lowestRail, getLane (rail, lane));
+
+            return -juce::Decibels::gainToDecibels (lowestRail);
+        }
+
+        void prepare (const juce::dsp::ProcessSpec& spec) noexcept
+        {
+            attack  = static_cast<float> (1.0 - std::exp (-1000.0 / (attackMilliseconds * spec.sampleRate)));
+            release = static_cast<float> (1.0 - std::exp (-1000.0 / (releaseMilliseconds * spec.sampleRate)));
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            envelope = SampleType (0.0f);
+            rail = inverseRail = SampleType (1.0f);
+            railStep = inverseRailStep = SampleType (0.0f);
+            railPosition = 0;
+            shaper.reset();
+        }
+
+        /** Stands in for numSamples of silence that are not processed: the supply
+            is left fully recharged (no sag) and the rail grid moves on as if
+            they had run. The tube stage keeps its state.
+        */
+        void skipSilence (size_t numSamples) noexcept
+        {
+            envelope = SampleType (0.0f);
+            rail = inverseRail = SampleType (1.0f);
+            railStep = inverseRailStep = SampleType (0.0f);
+            railPosition = static_cast<int> ((static_cast<size_t> (railPosition) + numSamples) % railUpdateInterval);
+        }
+
+        template <typename OtherSampleType>
+        void copyLaneFrom (const PowerStage<OtherSampleType>& source, size_t sourceLane, size_t destinationLane) noexcept
+        {
+            setLane (envelope, destinationLane, getLane (source.envelope, sourceLane));
+            setLane (rail, destinationLane, getLane (source.rail, sourceLane));
+            setLane (inverseRail, destinationLane, getLane (source.inverseRail, sourceLane));
+            setLane (railStep, destinationLane, getLane (source.railStep, sourceLane));
+            setLane (inverseRailStep, destinationLane, getLane (source.inverseRailStep, sourceLane));
+            railPosition = source.railPosition;
+            shaper.copyLaneFrom (source.shaper, sourceLane, destinationLane);
+        }
+
+        template <typename ProcessContext>
+        void process (const ProcessContext& context) noexcept
+        {
+            constexpr auto floatsPerSample = sizeof (SampleType) / sizeof (float);
+
+            auto&& inputBlock  = context.getInputBlock();
+            auto&& outputBlock = context.getOutputBlock();
+
+            jassert (inputBlock.getNumChannels() == 1 && outputBlock.getNumChannels() == 1);
+
+            if (context.isBypassed)
+            {
+                if (context.usesSeparateInputAndOutputBlocks())
+                    outputBlock.copyFrom (inputBlock);
+
+                return;
+            }
+
+            auto* input  = inputBlock.getChannelPointer (0);
+            auto* output = outputBlock.getChannelPointer (0);
+            auto numSamples = outputBlock.getNumSamples();
+
+            const auto vAttack = SampleType (attack), vRelease = SampleType (release);
+            SampleType rails[railUpdateInterval];
+
+            // Runs end on the rail grid; each one is followed, scaled into the
+            // table and scaled back by the rail each sample saw
+            for (size_t start = 0; start < numSamples;)
+            {
+                auto count = juce::jmin (numSamples - start, static_cast<size_t> (railUpdateInterval - railPosition));
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    auto x = input[start + i];
+                    auto level = getAbsolute (x);
+                    envelope = envelope + selectGreater (level, envelope, vAttack, vRelease) * (level - envelope);
+
+                    rails[i] = rail;
+                    output[start + i] = x * inverseRail;
+
+                    rail = rail + railStep;
+                    inverseRail = inverseRail + inverseRailStep;
+                }
+
+                shaper.process (reinterpret_cast<float*> (output + start), count * floatsPerSample, floatsPerSample);
+
+                for (size_t i = 0; i < count; ++i)
+                    output[start + i] = output[start + i] * rails[i];
+
+                start += count;
+                railPosition += static_cast<int> (count);
+
+                if (railPosition == railUpdateInterval)
+                {
+                    updateRail();
+                    railPosition = 0;
+                }
+            }
+        }
+
+    private:
+        template <typename> friend class PowerStage;
+
+        // Rail target from the envelope (tanh knee), reached over the next interval
+        void updateRail() noexcept
+        {
+            for (size_t lane = 0; lane < sizeof (SampleType) / sizeof (float); ++lane)
+            {
+                auto sag = std::tanh (getLane (envelope, lane) * sagSensitivity);
+                auto target = juce::Decibels::decibelsToGain (-maximumSagDecibels * sag);
+
+                setLane (railStep, lane, (target - getLane (rail, lane)) / static_cast<float> (railUpdateInterval));
+                setLane (inverseRailStep, lane, (1.0f / target - getLane (inverseRail, lane)) / static_cast<float> (railUpdateInterval));
+            }
+        }
+
+        TubeShaper shaper;
+
+        SampleType envelope { 0.0f };
+        SampleType rail { 1.0f }, inverseRail { 1.0f };
+        SampleType railStep { 0.0f }, inverseRailStep { 0.0f };
+        int railPosition = 0;
+        float attack = 0.0f, release = 0.0f;
+    };
+
+    //==============================================================================
+    /** Copies one lane of filter state between two stages (no-op for stateless stages). */
+    template <typename Destination, typename Source>
+    void copyLane (Destination&, const Source&, size_t, size_t) noexcept {}
+
+    inline void copyLane (TubeShaper& destination, const TubeShaper& source, size_t sourceLane, size_t destinationLane) noexcept
+    {
+        destination.copyLaneFrom (source, sourceLane, destinationLane);
+    }
+
+    template <template <typename> class Stage, typename DestinationType, typename SourceType>
+    auto copyLane (Stage<DestinationType>& destination, const Stage<SourceType>& source,
+                   size_t sourceLane, size_t destinationLane) noexcept
+        -> decltype (destination.copyLaneFrom (source, sourceLane, destinationLane))
+    {
+        destination.copyLaneFrom (source, sourceLane, destinationLane);
+    }
+
+    template <typename Destination, typename Source, size_t... Indices>
+    void copyChainLane (Destination& destination, const Source& source,
+                        size_t sourceLane, size_t destinationLane, std::index_sequence<Indices...>) noexcept
+    {
+        (copyLane (destination.template get<static_cast<int> (Indices)>(),
+                   source.template get<static_cast<int> (Indices)>(), sourceLane, destinationLane), ...);
+    }
+
+    /** Copies the state of one channel (lane) of a chain into a lane of another
+        chain with the same stages, e.g. from the mono chain into the vector chain.
+    */
+    template <typename... DestinationStages, typename... SourceStages>
+    void copyChainLane (juce::dsp::ProcessorChain<DestinationStages...>& destination,
+                        const juce::dsp::ProcessorChain<SourceStages...>& source,
+                        size_t sourceLane, size_t destinationLane) noexcept
+    {
+        static_assert (sizeof... (DestinationStages) == sizeof... (SourceStages));
+        copyChainLane (destination, source, sourceLane, destinationLane,
+                       std::make_index_sequence<sizeof... (DestinationStages)>());
+    }
+
+    //==============================================================================
+    /** Copies channels of a float block into the lanes of an interleaved SIMD block. */
+    inline void interleave (const juce::dsp::AudioBlock<float>& source,
+                            const juce::dsp::AudioBlock<juce::dsp::SIMDRegister<float>>& destination) noexcept
+    {
+        constexpr auto numLanes = juce::dsp::SIMDRegister<float>::size();
+        jassert (source.getNumChannels() <= numLanes);
+        jassert (source.getNumSamples() == destination.getNumSamples());
+
+        auto* lanes = reinterpret_cast<float*> (destination.getChannelPointer (0));
+
+        for (size_t channel = 0; channel < source.getNumChannels(); ++channel)
+        {
+            auto* input = source.getChannelPointer (channel);
+
+            for (size_t i = 0; i < source.getNumSamples(); ++i)
+                lanes[i * numLanes + channel] = input[i];
+        }
+    }
+
+    /** Copies lanes of an interleaved SIMD block back out to the channels of a float block. */
+    inline void deinterleave (const juce::dsp::AudioBlock<juce::dsp::SIMDRegister<float>>& source,
+                              const juce::dsp::AudioBlock<float>& destination) noexcept
+    {
+        constexpr auto numLanes = juce::dsp::SIMDRegister<float>::size();
+        jassert (destination.getNumChannels() <= numLanes);
+        jassert (source.getNumSamples() == destination.getNumSamples());
+
+        auto* lanes = reinterpret_cast<const float*> (source.getChannelPointer (0));
+
+        for (size_t channel = 0; channel < destination.getNumChannels(); ++channel)
+        {
+            auto* output = destination.getChannelPointer (channel);
+
+            for (size_t i = 0; i < destination.getNumSamples(); ++i)
+                output[i] = lanes[i * numLanes + channel];
+        }
+    }
+}
@@ -3,10 +3,20 @@
 
 //==============================================================================
 ClaudeAmpProcessorEditor::ClaudeAmpProcessorEditor (ClaudeAmpProcessor& p)
-    : AudioProcessorEditor (&p), processorRef (p)
+    : AudioProcessorEditor (&p), processorRef (p), meters (p.getTelemetry())
+   #if CLAUDEAMP_PROFILING
+    , loadOverlay (p.getProfiler())
+   #endif
 {
-    // Set editor size for 6 knobs + controls (960x300 - Marshall style)
-    setSize (960, 300);
+    // Set editor size for 6 knobs + controls (960x300 - Marshall style), meters below
+    addAndMakeVisible (meters);
+
+   #if CLAUDEAMP_PROFILING
+    addAndMakeVisible (loadOverlay);
+    setSize (960, 300 + AmpMeters::preferredHeight + DspLoadOverlay::preferredHeight);
+   #else
+    setSize (960, 300 + AmpMeters::preferredHeight);
+   #endif
 
     // Marshall color scheme
     auto marshallGold = juce::Colour (0xffd4af37);  // Classic Marshall gold
@@ -39,6 +49,41 @@ ClaudeAmpProcessorEditor::ClaudeAmpProcessorEditor (ClaudeAmpProcessor& p)
     linkAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (
         processorRef.apvts, "link", linkButton);
 
+    // Configure oversampling quality selectors (item order matches the parameter choices)
+    auto configureComboBox = [marshallGold](juce::ComboBox& comboBox, const juce::StringArray& items) {
+        comboBox.addItemList (items, 1);
+        comboBox.setColour (juce::ComboBox::backgroundColourId, juce::Colours::black);
+        comboBox.setColour (juce::ComboBox::textColourId, marshallGold);
+        comboBox.setColour (juce::ComboBox::outlineColourId, marshallGold);
+        comboBox.setColour (juce::ComboBox::arrowColourId, marshallGold);
+    };
+
+    configureComboBox (oversamplingSelector, { "AUTO", "1X", "2X", "4X", "8X", "1X ADAA", "2X ADAA" });
+    addAndMakeVisible (oversamplingSelector);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+        processorRef.apvts, "oversampling", oversamplingSelector);
+
+    configureComboBox (oversamplingFilterSelector, { "IIR", "LINEAR PHASE" });
+    addAndMakeVisible (oversamplingFilterSelector);
+    oversamplingFilterAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment> (
+        processorRef.apvts, "oversamplingFilter", oversamplingFilterSelector);
+
+    oversamplingLabel.setText ("QUALITY", juce::dontSendNotification);
+    oversamplingLabel.setJustificationType (juce::Justification::centred);
+    oversamplingLabel.setColour (juce::Label::textColourId, marshallGold);
+    oversamplingLabel.setFont (juce::Font (14.0f, juce::Font::bold));
+    addAndMakeVisible (oversamplingLabel);
+
+    // Configure cabinet IR menu button
+    cabinetButton.setColour (juce::TextButton::buttonColourId, juce::Colours::black);
+    cabinetButton.setColour (juce::TextButton::textColourOffId, marshallGold);
+    cabinetButton.setColour (juce::ComboBox::outlineColourId, marshallGold);
+    cabinetButton.onClick = [this] { showCabinetMenu(); };
+    addAndMakeVisible (cabinetButton);
+    cabinetModeAttachment = std::make_unique<juce::ParameterAttachment> (
+        *processorRef.apvts.getParameter ("cabinet"), [this] (float) { updateCabinetButton(); });
+    cabinetModeAttachment->sendInitialUpdate();
+
     // Helper lambda for configuring knobs with Marshall styling
     auto configureKnob = [marshallGold](juce::Slider& slider) {
         slider.setSliderStyle (juce::Slider::RotaryVerticalDrag);
@@ -117,6 +162,86 @@ ClaudeAmpProcessorEditor::~ClaudeAmpProcessorEditor()
 {
 }
 
+//==============================================================================
+void ClaudeAmpProcessorEditor::showCabinetMenu()
+{
+    auto options = processorRef.getCabinetOptions();
+    auto usingFile = processorRef.getCabinetFile() != juce::File();
+
+    juce::PopupMenu lengthMenu;
+    for (auto seconds : { 0.0, 0.1, 0.2, 0.5 })
+    {
+        lengthMenu.addItem (seconds > 0.0 ? juce::String (juce::roundToInt (seconds * 1000.0)) + " ms" : "Full", true,
+                            options.maximumLengthSeconds == seconds,
+                            [this, seconds]
+                            {
+                                auto newOptions = processorRef.getCabinetOptions();
+                                newOptions.maximumLengthSeconds = seconds;
+                                processorRef.setCabinetOptions (newOptions);
+                            });
+    }
+
+    // Mode (the "cabinet" parameter), with the lite model's fit against the full IR
+    juce::PopupMenu menu;
+    auto mode = static_cast<int> (processorRef.apvts.getRawParameterValue ("cabinet")->load());
+    auto modeNames = { "Off", "Lite (fitted IIR)", "Full (convolution)" };
+    auto index = 0;
+
+    for (auto* name : modeNames)
+    {
+        menu.addItem (name, true, mode == index, [this, index] { cabinetModeAttachment->setValueAsCompleteGesture (static_cast<float> (index)); });
+        ++index;
+    }
+
+    auto fitError = processorRef.getCabinetLiteFitError();
+    menu.addItem ("Lite fit: " + juce::String (fitError.rmsDecibels, 1) + " dB RMS, "
+                  + juce::String (fitError.maximumDecibels, 1) + " dB max", false, false, nullptr);
+    menu.addSeparator();
+
+    menu.addItem ("Built-in 4x12", true, ! usingFile, [this]
+    {
+        processorRef.useBuiltInCabinet();
+        updateCabinetButton();
+    });
+
+    menu.addItem ("Load IR file...", [this]
+    {
+        cabinetChooser = std::make_unique<juce::FileChooser> ("Load cabinet IR", juce::File(), "*.wav;*.aif;*.aiff;*.flac");
+        cabinetChooser->launchAsync (juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                     [this] (const juce::FileChooser& chooser)
+                                     {
+                                         auto file = chooser.getResult();
+
+                                         if (file != juce::File() && ! processorRef.loadCabinetImpulseResponse (file))
+                                             juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon,
+                                                                                     "Cabinet IR",
+                                                                                     "Could not read " + file.getFileName());
+
+                                         updateCabinetButton();
+                                     });
+    });
+
+    menu.addSeparator();
+    menu.addItem ("Minimum phase", true, options.minimumPhase, [this]
+    {
+        auto newOptions = processorRef.getCabinetOptions();
+        newOptions.minimumPhase = ! newOptions.minimumPhase;
+        processorRef.setCabinetOptions (newOptions);
+    });
+    menu.addSubMenu ("Length", lengthMenu);
+
+    menu.showMenuAsync (juce::PopupMenu::Options().withTargetComponent (cabinetButton));
+}
+
+void ClaudeAmpProcessorEditor::updateCabinetButton()
+{
+    auto mode = static_cast<int> (processorRef.apvts.getRawParameterValue ("cabinet")->load());
+    auto file = processorRef.getCabinetFile();
+    auto name = file == juce::File() ? juce::String ("4X12") : file.getFileNameWithoutExtension().toUpperCase();
+
+    cabinetButton.setButtonText (mode == 0 ? juce::String ("CAB: OFF") : (mode == 1 ? "CAB LITE: " : "CAB: ") + name);
+}
+
 //==============================================================================
 void ClaudeAmpProcessorEditor::paint (juce::Graphics& g)
 {
@@ -145,13 +270,19 @@ void ClaudeAmpProcessorEditor::paint (juce::Graphics& g)
     // Draw decorative panel lines (Marshall style)
     g.setColour (marshallGoldDark);
     g.drawLine (20, 60, getWidth() - 20, 60, 2.0f);
-    g.drawLine (20, getHeight() - 20, getWidth() - 20, getHeight() - 20, 2.0f);
+    g.drawLine (20, meters.getY() - 20, getWidth() - 20, meters.getY() - 20, 2.0f);
 }
 
 void ClaudeAmpProcessorEditor::resized()
 {
     auto area = getLocalBounds();
 
+   #if CLAUDEAMP_PROFILING
+    loadOverlay.setBounds (area.removeFromBottom (DspLoadOverlay::preferredHeight));
+   #endif
+
+    meters.setBounds (area.removeFromBottom (AmpMeters::preferredHeight));
+
     // Title area
     auto titleArea = area.removeFromTop (70);
 
@@ -167,6 +298,16 @@ void ClaudeAmpProcessorEditor::resized()
     auto linkArea = topControlsArea.removeFromRight (150);
     linkButton.setBounds (linkArea);
 
+    // Cabinet IR menu next to it
+    auto cabinetArea = topControlsArea.removeFromRight (150);
+    cabinetButton.setBounds (cabinetArea.withTrimmedRight (10));
+
+    // Oversampling quality in the middle
+    auto qualityArea = topControlsArea.withSizeKeepingCentre (330, topControlsArea.getHeight());
+    oversamplingLabel.setBounds (qualityArea.removeFromLeft (80));
+    oversamplingSelector.setBounds (qualityArea.removeFromLeft (90).withTrimmedLeft (10));
+    oversamplingFilterSelector.setBounds (qualityArea.withTrimmedLeft (10));
+
     // Knobs area
     auto knobsArea = area.reduced (20);
 
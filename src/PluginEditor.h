@@ -1,5 +1,7 @@
 #pragma once
 
+#include "AmpMeters.h"
+#include "DspLoadOverlay.h"
 #include "PluginProcessor.h"
 
 //==============================================================================
@@ -26,6 +28,20 @@ private:
     juce::ToggleButton linkButton;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> linkAttachment;
 
+    // Oversampling quality (factor + filter type)
+    juce::ComboBox oversamplingSelector;
+    juce::ComboBox oversamplingFilterSelector;
+    juce::Label oversamplingLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> oversamplingFilterAttachment;
+
+    // Cabinet menu (Off/Lite/Full, built-in IR or file, minimum phase, length)
+    juce::TextButton cabinetButton;
+    std::unique_ptr<juce::FileChooser> cabinetChooser;
+    std::unique_ptr<juce::ParameterAttachment> cabinetModeAttachment;
+    void showCabinetMenu();
+    void updateCabinetButton();
+
     // Rotary sliders (knobs) - Marshall Plexi style
     juce::Slider driveSlider;
     juce::Slider bassSlider;
@@ -50,5 +66,13 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> presenceAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> masterAttachment;
 
+    // Level, sag and tube clipping meters under the knobs
+    AmpMeters meters;
+
+   #if CLAUDEAMP_PROFILING
+    // DSP load strip along the bottom edge (profiling builds only)
+    DspLoadOverlay loadOverlay;
+   #endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClaudeAmpProcessorEditor)
 };
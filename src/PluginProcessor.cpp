@@ -1,5 +1,8 @@
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+
+#if ! CLAUDEAMP_HEADLESS
+ #include "PluginEditor.h"
+#endif
 
 //==============================================================================
 ClaudeAmpProcessor::ClaudeAmpProcessor()
@@ -13,11 +16,34 @@ ClaudeAmpProcessor::ClaudeAmpProcessor()
                        ),
        apvts (*this, nullptr, "PARAMETERS", createParameterLayout())
 {
+    // Identity biquads until prepareToPlay fills them in
+    for (auto* coefficients : { &preEmphasisCoefficients, &deEmphasisCoefficients, &presenceCoefficients })
+        *coefficients = new juce::dsp::IIR::Coefficients<float> (1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+
     initializeFactoryPresets();
+    initialiseTubeStages();
+
+    for (size_t i = 0; i < presetParameters.size(); ++i)
+        presetParameters[i] = apvts.getRawParameterValue (presetParameterIDs[i]);
+
+    cabinetParameter = apvts.getRawParameterValue ("cabinet");
+
+    for (size_t i = 0; i < stateParameters.size(); ++i)
+    {
+        stateParameters[i] = apvts.getParameter (BinaryState::parameterIDs[i]);
+        stateParameterValues[i] = apvts.getRawParameterValue (BinaryState::parameterIDs[i]);
+        jassert (stateParameters[i] != nullptr);
+    }
+
+    apvts.addParameterListener ("oversampling", this);
+    apvts.addParameterListener ("oversamplingFilter", this);
 }
 
 ClaudeAmpProcessor::~ClaudeAmpProcessor()
 {
+    apvts.removeParameterListener ("oversampling", this);
+    apvts.removeParameterListener ("oversamplingFilter", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -80,11 +106,31 @@ juce::AudioProcessorValueTreeState::ParameterLayout ClaudeAmpProcessor::createPa
         juce::NormalisableRange<float> (0.0f, 10.0f, 0.1f),
         5.0f));
 
-    // Cabinet Simulation (Marshall 4x12)
-    layout.add (std::make_unique<juce::AudioParameterBool> (
+    // Cabinet Simulation: Off, Lite (fitted biquads) or Full (convolution)
+    // Was an on/off bool; the normalised values 0 and 1 still mean Off and Full
+    layout.add (std::make_unique<juce::AudioParameterChoice> (
         "cabinet",
         "Cabinet",
-        true));  // Default: enabled
+        juce::StringArray ("Off", "Lite", "Full"),
+        2));  // Default: Full
+
+    // Oversampling quality (rebuilds the DSP, so not automatable)
+    // Auto picks the factor that keeps the internal rate near 176.4-192 kHz;
+    // the ADAA choices run anti-aliased tube stages at a low factor instead
+    layout.add (std::make_unique<juce::AudioParameterChoice> (
+        "oversampling",
+        "Oversampling",
+        juce::StringArray ("Auto", "1x", "2x", "4x", "8x", "1x ADAA", "2x ADAA"),
+        0,  // Default: Auto (4x at 44.1/48 kHz, as before)
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
+
+    // Oversampling filter: minimum-phase IIR (low latency) or linear-phase FIR
+    layout.add (std::make_unique<juce::AudioParameterChoice> (
+        "oversamplingFilter",
+        "Oversampling Filter",
+        juce::StringArray ("IIR", "Linear Phase"),
+        0,  // Default: IIR
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
 
     return layout;
 }
@@ -124,7 +170,8 @@ bool ClaudeAmpProcessor::isMidiEffect() const
 
 double ClaudeAmpProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    auto sampleRate = getSampleRate();
+    return sampleRate > 0.0 ? getTailLengthSamples() / sampleRate : 0.0;
 }
 
 int ClaudeAmpProcessor::getNumPrograms()
@@ -161,232 +208,355 @@ void ClaudeAmpProcessor::changeProgramName (int index, const juce::String& newNa
 //==============================================================================
 void ClaudeAmpProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+
     // Initialize DSP spec
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = static_cast<juce::uint32> (samplesPerBlock);
     spec.numChannels = static_cast<juce::uint32> (getTotalNumOutputChannels());
 
-    // Initialize 4x oversampling (2^2 = 4x)
-    oversampler = std::make_unique<juce::dsp::Oversampling<float>> (
-        spec.numChannels,
-        2,  // 2^2 = 4x oversampling
-        juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
-        true,  // Max quality
-        true   // Integer latency
-    );
-    oversampler->initProcessing (static_cast<size_t> (samplesPerBlock));
-
-    // Initialize look-up tables for tube saturation curves
-    // 12AX7 preamp tube: Asymmetric (harder positive clipping)
-    tube12AX7LUT.initialise ([](float x) {
-        if (x > 0.0f)
-            return std::tanh (x * 1.8f);      // Harder positive clipping
-        else
-            return std::tanh (x * 1.2f);      // Softer negative
-    }, -5.0f, 5.0f, 256);  // 256 points for accuracy
-
-    // EL34 power amp tube: More symmetrical, softer clipping
-    tubeEL34LUT.initialise ([](float x) {
-        return std::tanh (x * 0.8f);          // Softer, more symmetrical
-    }, -5.0f, 5.0f, 128);  // 128 points sufficient for symmetric curve
-
-    // Prepare the entire Plexi chain with oversampled spec
-    auto oversampledSpec = spec;
-    oversampledSpec.sampleRate = sampleRate * 4.0;
-    oversampledSpec.maximumBlockSize = static_cast<juce::uint32> (samplesPerBlock * 4);
-    plexiChain.prepare (oversampledSpec);
-
-    // Configure Stage 0: Input gain (controlled by Drive parameter)
-    auto& inputGain = plexiChain.get<0>();
-    inputGain.setGainDecibels (0.0f);
-
-    // Configure Stage 1: Channel brightness filter (configured in processBlock)
-    // Normal: 10 Hz HPF (full-range), Bright: 500 Hz HPF (emphasizes highs)
-    auto& channelFilter = plexiChain.get<1>();
-    channelFilter.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-
-    // Configure Stage 2: Pre-emphasis (+6 dB @ 5 kHz before saturation)
-    auto& preEmph = plexiChain.get<2>();
-    *preEmph.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf (
-        sampleRate * 4.0, 5000.0f, 0.707f, 1.995f);  // +6 dB
-
-    // Configure Stage 3: Preamp stage 1 bias (asymmetric for 12AX7)
-    auto& bias1 = plexiChain.get<3>();
-    bias1.setBias (0.3f);
-
-    // Configure Stage 4: Preamp stage 1 waveshaper (12AX7 with ~35dB gain)
-    // Real 12AX7: μ=100, practical gain 30-60x in circuit
-    auto& stage1 = plexiChain.get<4>();
-    stage1.functionToUse = [](float x) {
-        // 12AX7 first stage: soft overdrive, grid current compression
-        // Amplify significantly before saturation
-        x = x * 40.0f;  // Stage gain (~32dB, representing 12AX7 amplification)
-
-        // Grid conduction and asymmetric clipping
-        if (x > 1.2f)
-            return 1.0f;  // Hard clipping (grid conduction)
-        else if (x > 0.0f)
-            return x / (1.0f + std::pow (x * 1.5f, 2.5f));  // Asymmetric soft-knee
-        else if (x > -1.5f)
-            return x / (1.0f + std::pow (-x * 0.8f, 2.0f));  // Softer negative
-        else
-            return -0.95f;  // Grid cutoff
-    };
+    // The amp only needs the input channels (mono in, stereo out runs it once)
+    numAmpChannels = juce::jmin (getTotalNumInputChannels(), getTotalNumOutputChannels());
 
-    // Configure Stage 5: Coupling capacitor HPF (~20 Hz)
-    auto& hpf1 = plexiChain.get<5>();
-    hpf1.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    hpf1.setCutoffFrequency (20.0f);
-    hpf1.setResonance (0.707f);
-
-    // Configure Stage 6: Preamp stage 2 bias
-    auto& bias2 = plexiChain.get<6>();
-    bias2.setBias (0.35f);
-
-    // Configure Stage 7: Preamp stage 2 waveshaper (12AX7 with ~32dB gain)
-    // Second stage: more gain, harder clipping
-    auto& stage2 = plexiChain.get<7>();
-    stage2.functionToUse = [](float x) {
-        // 12AX7 second stage: harder overdrive
-        x = x * 35.0f;  // Stage gain (~31dB)
-
-        // Harder clipping than stage 1
-        if (x > 1.0f)
-            return 0.98f;
-        else if (x > 0.0f)
-            return x / (1.0f + std::pow (x * 2.0f, 2.2f));  // Harder asymmetric
-        else if (x > -1.2f)
-            return x / (1.0f + std::pow (-x * 1.2f, 2.0f));
-        else
-            return -0.92f;
-    };
+    // Oversampling factor and filter from the quality parameters
+    auto quality = OversamplingQuality::getQuality (static_cast<int> (apvts.getRawParameterValue ("oversampling")->load()), sampleRate);
+    auto linearPhase = static_cast<int> (apvts.getRawParameterValue ("oversamplingFilter")->load()) == 1;
 
-    // Configure Stage 8: Coupling HPF 2
-    auto& hpf2 = plexiChain.get<8>();
-    hpf2.setType (juce::dsp::StateVariableTPTFilterType::highpass);
-    hpf2.setCutoffFrequency (20.0f);
-    hpf2.setResonance (0.707f);
-
-    // Configure Stage 9: Preamp stage 3 bias
-    auto& bias3 = plexiChain.get<9>();
-    bias3.setBias (0.4f);  // Heaviest saturation stage
-
-    // Configure Stage 10: Preamp stage 3 waveshaper (12AX7 with ~28dB gain)
-    // Third stage: heaviest saturation, most aggressive clipping
-    auto& stage3 = plexiChain.get<10>();
-    stage3.functionToUse = [](float x) {
-        // 12AX7 third stage: most aggressive
-        x = x * 25.0f;  // Stage gain (~28dB)
-
-        // Very aggressive clipping
-        if (x > 0.8f)
-            return 0.95f;
-        else if (x > 0.0f)
-            return x / (1.0f + std::pow (x * 2.5f, 2.0f));  // Hard asymmetric
-        else if (x > -1.0f)
-            return x / (1.0f + std::pow (-x * 1.5f, 1.8f));
-        else
-            return -0.90f;
-    };
+    // Hosts re-prepare on every transport or buffer size change: when nothing that
+    // shapes the DSP changed, keep the oversampler, coefficients and buffers and
+    // only clear their state. Buffers are reallocated only if the block size grew
+    PreparedConfiguration configuration { sampleRate, getTotalNumInputChannels(), getTotalNumOutputChannels(),
+                                          quality.oversamplingStages, linearPhase, quality.antiderivative };
+    auto warm = oversampler != nullptr && configuration == preparedConfiguration;
+    auto grown = ! warm || samplesPerBlock > preparedBlockSize;
 
-    // Configure Stage 11: De-emphasis (-6 dB @ 5 kHz after saturation)
-    auto& deEmph = plexiChain.get<11>();
-    *deEmph.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf (
-        sampleRate * 4.0, 5000.0f, 0.707f, 0.501f);  // -6 dB
-
-    // Configure Stage 12-14: Tone stack (configured in processBlock with proper coefficients)
-    // These use IIR shelf/peak filters for proper EQ behavior
-
-    // Configure Stage 15: Power amp (EL34 push-pull with ~25dB gain)
-    // EL34: More symmetrical than 12AX7, natural compression
-    auto& powerAmp = plexiChain.get<15>();
-    powerAmp.functionToUse = [](float x) {
-        // EL34 power tube stage gain (~25dB, representing phase inverter + power amp)
-        x = x * 18.0f;  // ~25dB gain
-
-        // Symmetrical soft clipping (push-pull cancels even harmonics)
-        if (x > 1.5f)
-            return 0.95f;  // Soft limiting
-        else if (x < -1.5f)
-            return -0.95f;
-        else
-            return x / (1.0f + std::pow (std::abs (x) * 1.2f, 2.0f)) * std::copysign (1.0f, x);
-    };
+    if (! warm)
+    {
+        oversampler = std::make_unique<juce::dsp::Oversampling<float>> (
+            static_cast<size_t> (numAmpChannels),
+            quality.oversamplingStages,  // 2^stages oversampling
+            linearPhase ? juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                        : juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+            true,  // Max quality
+            true   // Integer latency
+        );
+    }
+
+    if (grown)
+    {
+        oversampler->initProcessing (static_cast<size_t> (samplesPerBlock));
+        preparedBlockSize = samplesPerBlock;
+    }
+    else
+    {
+        oversampler->reset();
+    }
+
+    preparedConfiguration = configuration;
+
+    auto oversamplingFactor = static_cast<int> (oversampler->getOversamplingFactor());
+    auto oversampledRate = sampleRate * oversamplingFactor;
+
+    // Both chains see a single channel: the mono signal, or the interleaved lanes
+    auto laneSpec = spec;
+    laneSpec.sampleRate = oversampledRate;
+    laneSpec.maximumBlockSize = static_cast<juce::uint32> (preparedBlockSize * oversamplingFactor);
+    laneSpec.numChannels = 1;
+
+    if (! warm)
+    {
+        // Stages 2 and 8: Pre-/de-emphasis around the preamp (±6 dB @ 5 kHz)
+        *preEmphasisCoefficients = *PlexiVoicing::makePreEmphasis (oversampledRate);
+        *deEmphasisCoefficients = *PlexiVoicing::makeDeEmphasis (oversampledRate);
+
+        // Stages 9 and 11: Tone stack and presence (coefficients updated in processBlock)
+        toneStackModel.prepare (oversampledRate);
+    }
+
+    // Stereo input runs both channels through one chain in SIMD lanes; the mono
+    // chain also serves stereo input whose channels are identical
+    jassert (static_cast<size_t> (numAmpChannels) <= VectorSample::size());
+    useVectorChain = numAmpChannels > 1;
+    processingDualMono = false;
+
+    // Meters pick up at the new rate, and the tube stages count clipping if they are open
+    telemetryActive = telemetry.isEnabled();
+    telemetry.prepare (sampleRate);
+
+    // Cheap either way: prepare() clears the filter state and recomputes fixed settings
+    prepareVariant (normalChains, laneSpec);
+    prepareVariant (brightChains, laneSpec);
+    prepareVariant (linkChains, laneSpec);
+
+    if (grown)
+        monoFadeBlock = juce::dsp::AudioBlock<float> (monoFadeData, 1, laneSpec.maximumBlockSize);
+
+    if (useVectorChain)
+    {
+        if (grown)
+        {
+            interleavedBlock = juce::dsp::AudioBlock<VectorSample> (interleavedData, 1, laneSpec.maximumBlockSize);
+            vectorFadeBlock = juce::dsp::AudioBlock<VectorSample> (vectorFadeData, 1, laneSpec.maximumBlockSize);
+        }
 
-    // Configure Stage 16: Presence (configured in processBlock)
-    // High-shelf boost for clarity and "air"
+        interleavedBlock.clear();  // Lanes beyond the channel count stay silent
+    }
 
-    // Configure Stage 17: DC blocker
-    auto& dcBlocker = plexiChain.get<17>();
-    dcBlocker.setType (juce::dsp::FirstOrderTPTFilterType::highpass);
-    dcBlocker.setCutoffFrequency (5.0f);
+    // The parameters are complete by now: a preset still on its way has landed
+    PresetSnapshot pendingPreset;
+    presetSnapshots.read (pendingPreset);
+    std::fill (std::begin (presetHeld), std::end (presetHeld), false);
+    presetGliding = false;
+    readControls();
 
-    // Stage 18: Master volume (configured in processBlock)
+    // The current voicing's variant runs from the start, with no fade pending
+    activeVoicing = PlexiVoicing::getVoicing (controls.channel, controls.link);
+    variantFadeLength = juce::jmax (1, juce::roundToInt (variantCrossfadeSeconds * oversampledRate));
+    variantFadePosition = variantFadeLength;
 
     // Initialize parameter smoothing (5ms ramp time for responsive feel)
-    driveSmoothed.reset (sampleRate, 0.005);
-    bassSmoothed.reset (sampleRate, 0.005);
-    midSmoothed.reset (sampleRate, 0.005);
-    trebleSmoothed.reset (sampleRate, 0.005);
-    presenceSmoothed.reset (sampleRate, 0.005);
-    masterSmoothed.reset (sampleRate, 0.005);
+    driveSmoothed.reset (sampleRate, PlexiVoicing::smoothingSeconds);
+    bassSmoothed.reset (sampleRate, PlexiVoicing::smoothingSeconds);
+    midSmoothed.reset (sampleRate, PlexiVoicing::smoothingSeconds);
+    trebleSmoothed.reset (sampleRate, PlexiVoicing::smoothingSeconds);
+    presenceSmoothed.reset (sampleRate, PlexiVoicing::smoothingSeconds);
+    masterSmoothed.reset (sampleRate, PlexiVoicing::smoothingSeconds);
 
     // Set initial target values to current parameter values
-    driveSmoothed.setCurrentAndTargetValue (apvts.getRawParameterValue ("drive")->load());
-    bassSmoothed.setCurrentAndTargetValue (apvts.getRawParameterValue ("bass")->load());
-    midSmoothed.setCurrentAndTargetValue (apvts.getRawParameterValue ("mid")->load());
-    trebleSmoothed.setCurrentAndTargetValue (apvts.getRawParameterValue ("treble")->load());
-    presenceSmoothed.setCurrentAndTargetValue (apvts.getRawParameterValue ("presence")->load());
-    masterSmoothed.setCurrentAndTargetValue (apvts.getRawParameterValue ("master")->load());
+    driveSmoothed.setCurrentAndTargetValue (controls.drive);
+    bassSmoothed.setCurrentAndTargetValue (controls.bass);
+    midSmoothed.setCurrentAndTargetValue (controls.mid);
+    trebleSmoothed.setCurrentAndTargetValue (controls.treble);
+    presenceSmoothed.setCurrentAndTargetValue (controls.presence);
+    masterSmoothed.setCurrentAndTargetValue (controls.master);
+
+    // Gains and coefficients are all computed afresh
+    staleControls = Controls::smoothedFlags;
+    updateDerivedControls();
+
+    // Fresh filter state has not settled on silence yet (the tube bias DC still has to ring out)
+    silentSamples = 0;
+
+    // Initialize cabinet IR convolution (rebuilt only for a new rate or channel count)
+    cabinet.prepare (spec);
+
+    cabinetOn = controls.cabinet != 0;
+    cabinetMode = controls.cabinet == 1 ? CabinetConvolution::Mode::lite : CabinetConvolution::Mode::full;
+    cabinetFadeLength = juce::jmax (1, juce::roundToInt (CabinetConvolution::crossfadeSeconds * sampleRate));
+    cabinetFadePosition = cabinetFadeLength;
+    cabinetDryBuffer.setSize (getTotalNumOutputChannels(), samplesPerBlock, false, false, true);
+
+    // Report latency to DAW: oversampling, plus the antiderivative tubes' delay
+    // (whole host samples at 1x and 2x). The cabinet convolution has none
+    auto latencySamples = static_cast<int> (oversampler->getLatencyInSamples()) + cabinet.getLatency();
+
+    if (quality.antiderivative)
+    {
+        jassert (PlexiVoicing::antiderivativeDelaySamples % oversamplingFactor == 0);
+        latencySamples += PlexiVoicing::antiderivativeDelaySamples / oversamplingFactor;
+    }
+
+    setLatencySamples (latencySamples);
+
+    lastPrepareMilliseconds = juce::Time::getMillisecondCounterHiRes() - startTime;
+    lastPrepareWasWarm = warm;
+}
+
+ClaudeAmpProcessor::PrepareStats ClaudeAmpProcessor::getLastPrepareStats() const noexcept
+{
+    return { lastPrepareMilliseconds.load(), lastPrepareWasWarm.load() };
+}
+
+//==============================================================================
+// Amp Chain
+
+template <typename Function>
+void ClaudeAmpProcessor::visitVariant (PlexiVoicing::Voicing voicing, Function&& function)
+{
+    switch (voicing)
+    {
+        case PlexiVoicing::Voicing::normal:  function (normalChains); break;
+        case PlexiVoicing::Voicing::bright:  function (brightChains); break;
+        case PlexiVoicing::Voicing::link:    function (linkChains); break;
+    }
+}
+
+template <typename Chain>
+void ClaudeAmpProcessor::prepareChain (Chain& chain, const juce::dsp::ProcessSpec& laneSpec)
+{
+    // The IIR stages point at the shared coefficient objects, so tone stack
+    // updates reach whichever chain is running
+    chain.template get<2>().coefficients = preEmphasisCoefficients;
+    chain.template get<8>().coefficients = deEmphasisCoefficients;
+    chain.template get<9>().coefficients = toneStackCoefficients;
+    chain.template get<11>().coefficients = presenceCoefficients;
+
+    chain.prepare (laneSpec);
 
-    // Initialize cabinet IR convolution
-    cabinetIR.prepare (spec);
+    // Channel filter, gains and tone stack follow the controls in processBlock
+    PlexiVoicing::configureFixedStages (chain);
+}
 
-    // Create a simple impulse response for Marshall 4x12 cabinet simulation
-    // TODO: Replace with actual measured IR from real Marshall cabinet
-    // This is a basic synthetic IR approximating speaker resonance and room
-    const int irLength = 2048;  // ~40ms @ 48kHz
-    juce::AudioBuffer<float> ir (static_cast<int> (spec.numChannels), irLength);
+template <PlexiVoicing::Voicing voicing>
+void ClaudeAmpProcessor::prepareVariant (ChainVariant<voicing>& variant, const juce::dsp::ProcessSpec& laneSpec)
+{
+    // The channel filter is fixed per variant, so it is set once here
+    prepareChain (variant.mono, laneSpec);
+    PlexiVoicing::configureChannelStage<voicing> (variant.mono);
+    PlexiVoicing::setAntiderivativeTubes (variant.mono, preparedConfiguration.antiderivative);
+    PlexiVoicing::setClipCounting (variant.mono, telemetryActive);
 
-    for (int channel = 0; channel < ir.getNumChannels(); ++channel)
+    if (useVectorChain)
     {
-        auto* irData = ir.getWritePointer (channel);
+        prepareChain (variant.vector, laneSpec);
+        PlexiVoicing::configureChannelStage<voicing> (variant.vector);
+        PlexiVoicing::setAntiderivativeTubes (variant.vector, preparedConfiguration.antiderivative);
+        PlexiVoicing::setClipCounting (variant.vector, telemetryActive);
+    }
+}
 
-        // Initial impulse with speaker resonance (~80 Hz)
-        for (int i = 0; i < irLength; ++i)
+void ClaudeAmpProcessor::initialiseTubeStages()
+{
+    for (auto voicing : { PlexiVoicing::Voicing::normal, PlexiVoicing::Voicing::bright, PlexiVoicing::Voicing::link })
+    {
+        visitVariant (voicing, [] (auto& variant)
         {
-            float t = static_cast<float> (i) / static_cast<float> (sampleRate);
+            PlexiVoicing::initialiseTubeStages (variant.mono);
+            PlexiVoicing::initialiseTubeStages (variant.vector);
+        });
+    }
+}
+
+template <typename Chain, typename SampleType>
+void ClaudeAmpProcessor::processChain (Chain& chain, juce::dsp::AudioBlock<SampleType> block, int numSamples) noexcept
+{
+    if (! isSmoothing())
+    {
+        // Settled: one parameter update and a single pass over the whole block
+        updateSmoothedStages (chain);
 
-            // Direct impulse
-            float direct = (i == 0) ? 0.8f : 0.0f;
+        juce::dsp::ProcessContextReplacing<SampleType> context (block);
+        PlexiVoicing::process (chain, context);
+        return;
+    }
+
+    // Ramping: gains and tone stack coefficients follow the smoothers every
+    // smoothingChunkSize input samples, independent of the host block size
+    auto factor = oversampler->getOversamplingFactor();
 
-            // Speaker resonance (damped sine wave at 80 Hz)
-            float resonance = std::sin (2.0f * juce::MathConstants<float>::pi * 80.0f * t)
-                            * std::exp (-t * 50.0f) * 0.3f;
+    for (int start = 0; start < numSamples; start += smoothingChunkSize)
+    {
+        auto chunkSize = juce::jmin (smoothingChunkSize, numSamples - start);
 
-            // High-frequency rolloff (speaker cone breakup ~4 kHz)
-            float envelope = std::exp (-t * 8.0f);
+        driveSmoothed.skip (chunkSize);
+        bassSmoothed.skip (chunkSize);
+        midSmoothed.skip (chunkSize);
+        trebleSmoothed.skip (chunkSize);
+        presenceSmoothed.skip (chunkSize);
+        masterSmoothed.skip (chunkSize);
 
-            // Early reflections (simulated cabinet and room)
-            float reflection1 = (i == 64) ? 0.15f : 0.0f;   // ~1.3ms
-            float reflection2 = (i == 128) ? 0.08f : 0.0f;  // ~2.7ms
-            float reflection3 = (i == 256) ? 0.04f : 0.0f;  // ~5.3ms
+        updateSmoothedStages (chain);
 
-            irData[i] = (direct + resonance + reflection1 + reflection2 + reflection3) * envelope;
-        }
+        auto chunkBlock = block.getSubBlock (static_cast<size_t> (start) * factor,
+                                             static_cast<size_t> (chunkSize) * factor);
+        juce::dsp::ProcessContextReplacing<SampleType> context (chunkBlock);
+        PlexiVoicing::process (chain, context);
+    }
+}
+
+template <typename SampleType, typename GetChain>
+void ClaudeAmpProcessor::processVariants (juce::dsp::AudioBlock<SampleType> block, juce::dsp::AudioBlock<SampleType> fadeBlock,
+                                          int numSamples, GetChain&& getChain) noexcept
+{
+    jassert (block.getNumChannels() == 1);
+
+    if (! isFadingVariant())
+    {
+        visitVariant (activeVoicing, [&] (auto& variant) { processChain (getChain (variant), block, numSamples); });
+        return;
+    }
+
+    // The outgoing variant runs on a copy. Both have to follow the same control
+    // ramps, so the smoothers are rewound before the incoming one runs
+    std::array<juce::SmoothedValue<float>*, 6> smoothers { &driveSmoothed, &bassSmoothed, &midSmoothed,
+                                                           &trebleSmoothed, &presenceSmoothed, &masterSmoothed };
+    std::array<juce::SmoothedValue<float>, 6> rewind;
+    auto rewindStaleControls = staleControls;
+
+    for (size_t i = 0; i < smoothers.size(); ++i)
+        rewind[i] = *smoothers[i];
+
+    auto oldBlock = fadeBlock.getSubBlock (0, block.getNumSamples());
+    oldBlock.copyFrom (block);
+    visitVariant (fadingVoicing, [&] (auto& variant) { processChain (getChain (variant), oldBlock, numSamples); });
+
+    for (size_t i = 0; i < smoothers.size(); ++i)
+        *smoothers[i] = rewind[i];
+
+    staleControls = rewindStaleControls;
+
+    visitVariant (activeVoicing, [&] (auto& variant) { processChain (getChain (variant), block, numSamples); });
+
+    // Output ramps linearly from the old variant to the new one
+    auto* output = block.getChannelPointer (0);
+    auto* faded = oldBlock.getChannelPointer (0);
+
+    for (size_t i = 0; i < block.getNumSamples(); ++i)
+    {
+        auto gain = juce::jmin (1.0f, static_cast<float> (variantFadePosition + static_cast<int> (i))
+                                    / static_cast<float> (variantFadeLength));
+        output[i] = faded[i] + SampleType (gain) * (output[i] - faded[i]);
     }
+}
+
+void ClaudeAmpProcessor::startVariantFade (PlexiVoicing::Voicing voicing) noexcept
+{
+    // The incoming variant continues from the running state. Its channel filter
+    // takes over the outgoing one's state at its own cutoff; the fade covers the step
+    visitVariant (voicing, [this] (auto& target)
+    {
+        visitVariant (activeVoicing, [this, &target] (auto& source)
+        {
+            target.mono.reset();
+            target.vector.reset();
+
+            if (useVectorChain && ! processingDualMono)
+            {
+                for (size_t lane = 0; lane < static_cast<size_t> (numAmpChannels); ++lane)
+                    PlexiStages::copyChainLane (target.vector, source.vector, lane, lane);
+            }
+            else
+            {
+                PlexiStages::copyChainLane (target.mono, source.mono, 0, 0);
+            }
+        });
+    });
+
+    fadingVoicing = activeVoicing;
+    activeVoicing = voicing;
+    variantFadePosition = 0;
+}
+
+//==============================================================================
+// Oversampling Quality
+
+void ClaudeAmpProcessor::parameterChanged (const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused (parameterID, newValue);
+
+    // Rebuilding the oversampler allocates, so defer it to the message thread
+    triggerAsyncUpdate();
+}
 
-    // Load the IR into the convolution engine
-    cabinetIR.loadImpulseResponse (std::move (ir),
-                                    sampleRate,
-                                    juce::dsp::Convolution::Stereo::yes,
-                                    juce::dsp::Convolution::Trim::no,
-                                    juce::dsp::Convolution::Normalise::yes);
+void ClaudeAmpProcessor::handleAsyncUpdate()
+{
+    if (getSampleRate() <= 0.0)
+        return;  // Not prepared yet: prepareToPlay will pick the settings up
 
-    // Report latency to DAW (from oversampling + convolution)
-    auto latencySamples = oversampler->getLatencyInSamples() + cabinetIR.getLatency();
-    setLatencySamples (static_cast<int> (latencySamples));
+    suspendProcessing (true);
+    prepareToPlay (getSampleRate(), getBlockSize());
+    suspendProcessing (false);
 }
 
 void ClaudeAmpProcessor::releaseResources()
@@ -404,7 +574,9 @@ bool ClaudeAmpProcessor::isBusesLayoutSupported (const BusesLayout& layouts) con
         return false;
 
    #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+    // Mono in, stereo out is allowed: the amp runs once and is fanned out
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet()
+     && layouts.getMainInputChannelSet() != juce::AudioChannelSet::mono())
         return false;
    #endif
 
@@ -412,11 +584,21 @@ bool ClaudeAmpProcessor::isBusesLayoutSupported (const BusesLayout& layouts) con
   #endif
 }
 
+bool ClaudeAmpProcessor::isDualMono (const juce::AudioBuffer<float>& buffer, int numSamples) noexcept
+{
+    jassert (buffer.getNumChannels() >= 2);
+
+    // Bit-identical only: anything else still gets true stereo processing
+    return std::memcmp (buffer.getReadPointer (0), buffer.getReadPointer (1),
+                        sizeof (float) * static_cast<size_t> (numSamples)) == 0;
+}
+
 void ClaudeAmpProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                        juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused (midiMessages);
     juce::ScopedNoDenormals noDenormals;
+    CLAUDEAMP_PROFILE_BLOCK (profiler, buffer.getNumSamples(), getSampleRate());
 
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -425,207 +607,596 @@ void ClaudeAmpProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // Get parameter values (thread-safe atomic read)
-    auto channel = static_cast<int> (apvts.getRawParameterValue ("channel")->load());
-    auto link = apvts.getRawParameterValue ("link")->load() > 0.5f;
-    auto drive = apvts.getRawParameterValue ("drive")->load();
-    auto bass = apvts.getRawParameterValue ("bass")->load();
-    auto mid = apvts.getRawParameterValue ("mid")->load();
-    auto treble = apvts.getRawParameterValue ("treble")->load();
-    auto presence = apvts.getRawParameterValue ("presence")->load();
-    auto master = apvts.getRawParameterValue ("master")->load();
-
-    // Update smoothed target values
-    driveSmoothed.setTargetValue (drive);
-    bassSmoothed.setTargetValue (bass);
-    midSmoothed.setTargetValue (mid);
-    trebleSmoothed.setTargetValue (treble);
-    presenceSmoothed.setTargetValue (presence);
-    masterSmoothed.setTargetValue (master);
-
-    // Advance smoothing by the number of samples in this block
+    // A glide to a preset has finished: knob moves smooth over the usual time again
+    if (presetGliding && ! isSmoothing())
+    {
+        for (auto* smoother : { &driveSmoothed, &bassSmoothed, &midSmoothed,
+                                &trebleSmoothed, &presenceSmoothed, &masterSmoothed })
+            smoother->reset (getSampleRate(), PlexiVoicing::smoothingSeconds);
+
+        presetGliding = false;
+    }
+
+    // Get parameter values (thread-safe atomic reads, a new preset as a whole)
+    auto changed = readControls();
+
+    // Only controls that moved get a new target, and mark what they feed as stale
+    if ((changed & Controls::driveFlag) != 0)     driveSmoothed.setTargetValue (controls.drive);
+    if ((changed & Controls::bassFlag) != 0)      bassSmoothed.setTargetValue (controls.bass);
+    if ((changed & Controls::midFlag) != 0)       midSmoothed.setTargetValue (controls.mid);
+    if ((changed & Controls::trebleFlag) != 0)    trebleSmoothed.setTargetValue (controls.treble);
+    if ((changed & Controls::presenceFlag) != 0)  presenceSmoothed.setTargetValue (controls.presence);
+    if ((changed & Controls::masterFlag) != 0)    masterSmoothed.setTargetValue (controls.master);
+
+    staleControls |= changed & Controls::smoothedFlags;
+
     auto numSamples = buffer.getNumSamples();
-    driveSmoothed.skip (numSamples);
-    bassSmoothed.skip (numSamples);
-    midSmoothed.skip (numSamples);
-    trebleSmoothed.skip (numSamples);
-    presenceSmoothed.skip (numSamples);
-    masterSmoothed.skip (numSamples);
-
-    // Get current smoothed values (after advancing)
-    auto currentDrive = driveSmoothed.getCurrentValue();
-    auto currentBass = bassSmoothed.getCurrentValue();
-    auto currentMid = midSmoothed.getCurrentValue();
-    auto currentTreble = trebleSmoothed.getCurrentValue();
-    auto currentPresence = presenceSmoothed.getCurrentValue();
-    auto currentMaster = masterSmoothed.getCurrentValue();
-
-    // Calculate power supply sag (dynamic compression)
-    float sagAmount = calculatePowerSupplySag (buffer);
-
-    // Update input gain based on Drive parameter
-    // Real Plexi has 60-90dB total preamp gain (3 stages @ 30-40dB each)
-    // Drive controls the input level feeding the cascaded gain stages
-    auto& inputGain = plexiChain.get<0>();
-    auto driveGain = currentDrive * 6.0f - (sagAmount * 8.0f);  // 0→0dB, 5→30dB, 10→60dB
-    inputGain.setGainDecibels (driveGain);
-
-    // Update channel brightness filter
-    // Simulates different cathode bypass capacitor values in real Plexi:
-    // Normal: 330µF (full-range gain, thicker bass)
-    // Bright: 0.68µF (gain rolloff below 285Hz, more aggressive/crunchy)
-    auto& channelFilter = plexiChain.get<1>();
-    if (link)  // Channel linking enabled - blend both channels
-    {
-        // Blend approximates Normal + Bright (jumper cable trick)
-        channelFilter.setCutoffFrequency (150.0f);  // Gentle bass reduction
-        channelFilter.setResonance (0.5f);          // Smooth rolloff
-    }
-    else if (channel == 0)  // Normal channel (330µF cathode bypass)
-    {
-        channelFilter.setCutoffFrequency (10.0f);   // Full-range, thick bass
-        channelFilter.setResonance (0.707f);
-    }
-    else  // Bright channel (0.68µF cathode bypass)
-    {
-        channelFilter.setCutoffFrequency (285.0f);  // Rolloff below 285Hz (authentic)
-        channelFilter.setResonance (0.6f);          // Slightly peaky for "bright" character
-    }
-
-    // Interactive tone stack (Marshall 1987 Plexi passive network)
-    // Based on authentic component values: 33kΩ/500pF/0.022µF/0.022µF
-    auto oversampledRate = getSampleRate() * 4.0;
-
-    // Bass control: Low-shelf @ 50Hz (authentic Plexi bass frequency)
-    // Real Plexi bass centered at 50Hz, not 200Hz
-    auto& bassTone = plexiChain.get<12>();
-    auto bassFreq = 50.0f + (currentTreble * 8.0f);  // Treble slightly pushes bass up (30-130Hz range)
-    auto bassGainDB = (currentBass - 5.0f) * 2.4f;   // ±12dB range
-    auto bassQ = 0.707f + (currentMid * 0.08f);      // Mid affects bass Q slightly
-    auto bassGain = juce::Decibels::decibelsToGain (bassGainDB);
-    *bassTone.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf (
-        oversampledRate, bassFreq, bassQ, bassGain);
-
-    // Mid control: Peaking @ 500-800Hz with characteristic Plexi scoop
-    // Creates the famous Marshall mid-scoop when bass/treble are up and mid is down
-    auto& midTone = plexiChain.get<13>();
-    auto midFreq = 650.0f + (currentBass * 30.0f) + (currentTreble * 15.0f);  // 650-1100Hz range
-    auto midGainDB = (currentMid - 5.0f) * 2.0f;     // ±10dB (less range than bass/treble)
-    auto midQ = 1.4f - (currentBass * 0.08f) - (currentTreble * 0.08f);  // Narrower Q when bass/treble high
-    auto midGain = juce::Decibels::decibelsToGain (midGainDB);
-    *midTone.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter (
-        oversampledRate, midFreq, midQ, midGain);
-
-    // Treble control: High-shelf @ 10kHz (authentic Plexi treble, not 3kHz!)
-    // Real Plexi has bright, cutting highs centered at 10kHz
-    auto& trebleTone = plexiChain.get<14>();
-    auto trebleFreq = 9500.0f + (currentBass * 50.0f);  // 9.5-10kHz range (bass interaction)
-    auto trebleGainDB = (currentTreble - 5.0f) * 2.4f;  // ±12dB range
-    auto trebleQ = 0.707f + (currentMid * 0.05f);       // Mid slightly affects treble Q
-    auto trebleGain = juce::Decibels::decibelsToGain (trebleGainDB);
-    *trebleTone.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf (
-        oversampledRate, trebleFreq, trebleQ, trebleGain);
-
-    // Presence control: Broad high-frequency boost starting at 1kHz
-    // Models negative feedback reduction (not simple high-shelf)
-    // Real Plexi presence affects 1kHz+ with broad, gentle boost
-    auto& presenceFilter = plexiChain.get<16>();
-    auto presenceGainDB = currentPresence * 0.8f;  // 0→0dB, 5→+4dB, 10→+8dB (conservative)
-    auto presenceGain = juce::Decibels::decibelsToGain (presenceGainDB);
-    *presenceFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf (
-        oversampledRate, 1200.0f, 0.5f, presenceGain);  // Start at 1.2kHz, broad Q
-
-    // Update master volume (0-10 → -20 to +20 dB)
-    auto& masterGain = plexiChain.get<18>();
-    auto masterDB = -20.0f + (currentMaster * 4.0f);  // 0→-20dB, 5→0dB, 10→+20dB
-    masterGain.setGainDecibels (masterDB);
+
+    // Meters are measured only while an editor reads them
+    if (telemetry.isEnabled() != telemetryActive)
+        setTelemetryActive (! telemetryActive);
+
+    if (telemetryActive)
+        telemetry.addInput (buffer, numAmpChannels, numSamples);
+
+    // Silent input with settled controls: after the tail has rung out and the
+    // sag has recharged there is nothing left to compute. Anything else
+    // restarts the countdown from the block's last loud sample
+    auto smoothing = isSmoothing();
+
+    if (! smoothing && isSilent (buffer, numAmpChannels, numSamples))
+    {
+        if (silentSamples >= getSilenceSkipSamples())
+        {
+            skipSilence (numSamples);
+            buffer.clear();
+
+            if (telemetryActive)
+                publishTelemetry (buffer, numSamples, false);
+
+            return;
+        }
+
+        silentSamples = juce::jmin (silentSamples + numSamples, std::numeric_limits<int>::max() / 2);
+    }
+    else
+    {
+        silentSamples = smoothing ? 0 : getTrailingSilence (buffer, numAmpChannels, numSamples);
+    }
 
     // Process audio through chain with oversampling
     juce::dsp::AudioBlock<float> block (buffer);
+    auto ampBlock = block.getSubsetChannelBlock (0, static_cast<size_t> (numAmpChannels));
+
+    // Channel or link changes switch chain variants, one crossfade at a time
+    auto voicing = PlexiVoicing::getVoicing (controls.channel, controls.link);
+
+    if (voicing != activeVoicing && ! isFadingVariant())
+        startVariantFade (voicing);
+
+    // Identical L/R input (e.g. a mono DI on a stereo track) only needs the amp once
+    auto dualMono = useVectorChain && isDualMono (buffer, numSamples);
+
+    if (dualMono != processingDualMono)
+    {
+        // Hand the running state over so the switch is seamless
+        auto handOver = [dualMono] (auto& variant)
+        {
+            if (dualMono)
+            {
+                PlexiStages::copyChainLane (variant.mono, variant.vector, 0, 0);
+            }
+            else
+            {
+                PlexiStages::copyChainLane (variant.vector, variant.mono, 0, 0);
+                PlexiStages::copyChainLane (variant.vector, variant.mono, 0, 1);
+            }
+        };
+
+        visitVariant (activeVoicing, handOver);
+
+        if (isFadingVariant())
+            visitVariant (fadingVoicing, handOver);
+
+        processingDualMono = dualMono;
+    }
+
+    // Upsample (2^n times, see prepareToPlay)
+    juce::dsp::AudioBlock<float> oversampledBlock;
+    {
+        CLAUDEAMP_PROFILE_SECTION (profiler, oversampling);
+        oversampledBlock = oversampler->processSamplesUp (ampBlock);
+    }
+
+    {
+        CLAUDEAMP_PROFILE_SECTION (profiler, chain);
+
+        auto getMonoChain = [] (auto& variant) -> auto& { return variant.mono; };
+        auto getVectorChain = [] (auto& variant) -> auto& { return variant.vector; };
+
+        if (dualMono)
+        {
+            // Both oversampling channels keep running so stereo can resume
+            // without a transient; only the amp itself is shared
+            processVariants (oversampledBlock.getSingleChannelBlock (0), monoFadeBlock, numSamples, getMonoChain);
+            oversampledBlock.getSingleChannelBlock (1).copyFrom (oversampledBlock.getSingleChannelBlock (0));
+        }
+        else if (useVectorChain)
+        {
+            // One pass over interleaved lanes processes every channel at once
+            auto lanes = interleavedBlock.getSubBlock (0, oversampledBlock.getNumSamples());
 
-    // Upsample to 4x
-    auto oversampledBlock = oversampler->processSamplesUp (block);
+            PlexiStages::interleave (oversampledBlock, lanes);
+            processVariants (lanes, vectorFadeBlock, numSamples, getVectorChain);
+            PlexiStages::deinterleave (lanes, oversampledBlock);
+        }
+        else
+        {
+            processVariants (oversampledBlock, monoFadeBlock, numSamples, getMonoChain);
+        }
 
-    // Process through Plexi chain
-    juce::dsp::ProcessContextReplacing<float> context (oversampledBlock);
-    plexiChain.process (context);
+        if (isFadingVariant())
+            variantFadePosition = juce::jmin (variantFadeLength, variantFadePosition + static_cast<int> (oversampledBlock.getNumSamples()));
+    }
 
     // Downsample back to original rate
-    oversampler->processSamplesDown (block);
+    {
+        CLAUDEAMP_PROFILE_SECTION (profiler, oversampling);
+        oversampler->processSamplesDown (ampBlock);
+    }
+
+    // Mono input: fan the amp out to the remaining outputs ahead of the cabinet
+    for (auto i = numAmpChannels; i < totalNumOutputChannels; ++i)
+        buffer.copyFrom (i, 0, buffer, 0, 0, numSamples);
+
+    // Apply cabinet IR (convolution, or its fitted lite model) if enabled.
+    // Switching it on or off fades against the dry signal; on starts it clean
+    if ((controls.cabinet != 0) != cabinetOn)
+    {
+        cabinetOn = controls.cabinet != 0;
+        cabinetFadePosition = 0;
+
+        if (cabinetOn)
+            cabinet.reset();
+    }
 
-    // Apply cabinet IR convolution if enabled
-    auto cabinetEnabled = apvts.getRawParameterValue ("cabinet")->load() > 0.5f;
-    if (cabinetEnabled)
+    if (cabinetOn)
+        cabinetMode = controls.cabinet == 1 ? CabinetConvolution::Mode::lite : CabinetConvolution::Mode::full;
+
+    if (cabinetOn || cabinetFadePosition < cabinetFadeLength)
     {
+        CLAUDEAMP_PROFILE_SECTION (profiler, cabinet);
+        auto fading = cabinetFadePosition < cabinetFadeLength;
+
+        if (fading)
+            for (int i = 0; i < totalNumOutputChannels; ++i)
+                cabinetDryBuffer.copyFrom (i, 0, buffer, i, 0, numSamples);
+
         juce::dsp::AudioBlock<float> cabinetBlock (buffer);
         juce::dsp::ProcessContextReplacing<float> cabinetContext (cabinetBlock);
-        cabinetIR.process (cabinetContext);
+        cabinet.process (cabinetContext, cabinetMode);
+
+        if (fading)
+        {
+            for (int i = 0; i < totalNumOutputChannels; ++i)
+            {
+                auto* output = buffer.getWritePointer (i);
+                auto* dry = cabinetDryBuffer.getReadPointer (i);
+
+                for (int sample = 0; sample < numSamples; ++sample)
+                {
+                    auto gain = juce::jmin (1.0f, static_cast<float> (cabinetFadePosition + sample)
+                                                / static_cast<float> (cabinetFadeLength));
+                    auto wet = cabinetOn ? gain : 1.0f - gain;
+                    output[sample] = dry[sample] + wet * (output[sample] - dry[sample]);
+                }
+            }
+
+            cabinetFadePosition = juce::jmin (cabinetFadeLength, cabinetFadePosition + numSamples);
+        }
     }
+
+    if (telemetryActive)
+        publishTelemetry (buffer, numSamples, true);
+}
+
+void ClaudeAmpProcessor::setTelemetryActive (bool shouldBeActive) noexcept
+{
+    telemetryActive = shouldBeActive;
+    telemetry.clear();
+
+    for (auto voicing : { PlexiVoicing::Voicing::normal, PlexiVoicing::Voicing::bright, PlexiVoicing::Voicing::link })
+    {
+        visitVariant (voicing, [shouldBeActive] (auto& variant)
+        {
+            PlexiVoicing::setClipCounting (variant.mono, shouldBeActive);
+            PlexiVoicing::setClipCounting (variant.vector, shouldBeActive);
+        });
+    }
+}
+
+void ClaudeAmpProcessor::publishTelemetry (const juce::AudioBuffer<float>& buffer, int numSamples, bool ampRan) noexcept
+{
+    telemetry.addOutput (buffer, getTotalNumOutputChannels(), numSamples);
+
+    // Clip counts come from the chain that ran: the mono one for dual-mono
+    // input, and only the active variant's (an outgoing one's are dropped)
+    auto vector = useVectorChain && ! processingDualMono;
+    auto numLanes = vector ? numAmpChannels : 1;
+    int clipped[PlexiVoicing::numTubeStages] {};
+    int dropped[PlexiVoicing::numTubeStages] {};
+    auto sagDecibels = 0.0f;
+
+    for (auto voicing : { PlexiVoicing::Voicing::normal, PlexiVoicing::Voicing::bright, PlexiVoicing::Voicing::link })
+    {
+        visitVariant (voicing, [&] (auto& variant)
+        {
+            auto active = voicing == activeVoicing;
+
+            PlexiVoicing::takeClippedSamples (variant.mono, 1, active && ! vector ? clipped : dropped);
+            PlexiVoicing::takeClippedSamples (variant.vector, static_cast<size_t> (numLanes), active && vector ? clipped : dropped);
+
+            if (active)
+                sagDecibels = vector ? variant.vector.template get<10>().getSagDecibels()
+                                     : variant.mono.template get<10>().getSagDecibels();
+        });
+    }
+
+    auto stageSamples = ampRan ? numSamples * static_cast<int> (oversampler->getOversamplingFactor()) * numLanes : 0;
+
+    telemetry.addStages (clipped, stageSamples, sagDecibels);
+    telemetry.endBlock (numSamples);
 }
 
 //==============================================================================
-// Power Supply Sag Modeling
-float ClaudeAmpProcessor::calculatePowerSupplySag (const juce::AudioBuffer<float>& buffer)
+// Smoothed Parameters
+
+juce::uint32 ClaudeAmpProcessor::readControls() noexcept
+{
+    float values[numPresetControls];
+    auto presetArrived = getPresetControls (values);
+
+    Controls next;
+    next.channel = static_cast<int> (values[0]);
+    next.link = values[1] > 0.5f;
+    next.drive = values[2];
+    next.bass = values[3];
+    next.mid = values[4];
+    next.treble = values[5];
+    next.presence = values[6];
+    next.master = values[7];
+    next.cabinet = static_cast<int> (cabinetParameter->load());
+
+    juce::uint32 changed = 0;
+    auto compare = [&changed] (bool moved, juce::uint32 flag) { if (moved) changed |= flag; };
+
+    compare (next.channel != controls.channel,   Controls::channelFlag);
+    compare (next.link != controls.link,         Controls::linkFlag);
+    compare (next.drive != controls.drive,       Controls::driveFlag);
+    compare (next.bass != controls.bass,         Controls::bassFlag);
+    compare (next.mid != controls.mid,           Controls::midFlag);
+    compare (next.treble != controls.treble,     Controls::trebleFlag);
+    compare (next.presence != controls.presence, Controls::presenceFlag);
+    compare (next.master != controls.master,     Controls::masterFlag);
+    compare (next.cabinet != controls.cabinet,   Controls::cabinetFlag);
+
+    // A preset restarts every smoother's ramp, so they all need their target again
+    if (presetArrived)
+        changed |= Controls::smoothedFlags;
+
+    controls = next;
+    return changed;
+}
+
+template <typename Chain>
+void ClaudeAmpProcessor::updateSmoothedStages (Chain& chain) noexcept
 {
-    // Calculate RMS level of signal (envelope following)
-    float rms = 0.0f;
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    // Only what a moving control feeds is recomputed: a settled amp skips it all
+    updateDerivedControls();
+
+    // The gains live in each chain, which may not have run since they changed
+    chain.template get<0>().setGainLinear (inputGain);
+    chain.template get<13>().setGainLinear (masterGain);
+}
+
+void ClaudeAmpProcessor::updateDerivedControls() noexcept
+{
+    // Recomputes a quantity while its controls are stale; they stay stale
+    // until the smoothers have landed and the final value has been applied
+    auto update = [this] (juce::uint32 flags, bool smoothing, auto&& recompute)
     {
-        auto* data = buffer.getReadPointer (channel);
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        if ((staleControls & flags) == 0)
+            return;
+
+        recompute();
+
+        if (! smoothing)
+            staleControls &= ~flags;
+    };
+
+    // Stage 0: input level from Drive (sag acts at the power stage)
+    update (Controls::driveFlag, driveSmoothed.isSmoothing(), [this]
+    {
+        inputGain = juce::Decibels::decibelsToGain (PlexiVoicing::getInputGainDecibels (driveSmoothed.getCurrentValue()));
+    });
+
+    // Stage 9: interactive tone stack, in closed form
+    update (Controls::toneStackFlags,
+            bassSmoothed.isSmoothing() || midSmoothed.isSmoothing() || trebleSmoothed.isSmoothing(), [this]
+    {
+        toneStackModel.getToneStack (bassSmoothed.getCurrentValue(), midSmoothed.getCurrentValue(),
+                                     trebleSmoothed.getCurrentValue(), toneStackCoefficients);
+    });
+
+    // Stage 11: presence, interpolated from its table. Coefficients are written
+    // in place: no Coefficients objects are created here
+    jassert (presenceCoefficients->coefficients.size() == ToneStackModel::coefficientsPerFilter);
+
+    update (Controls::presenceFlag, presenceSmoothed.isSmoothing(), [this]
+    {
+        toneStackModel.getPresence (presenceSmoothed.getCurrentValue(), presenceCoefficients->getRawCoefficients());
+    });
+
+    // Stage 13: master volume
+    update (Controls::masterFlag, masterSmoothed.isSmoothing(), [this]
+    {
+        masterGain = juce::Decibels::decibelsToGain (PlexiVoicing::getMasterGainDecibels (masterSmoothed.getCurrentValue()));
+    });
+}
+
+//==============================================================================
+// Silence Skipping
+
+int ClaudeAmpProcessor::getTailLengthSamples() const noexcept
+{
+    // Oversampling filters, then the amp's filters, then the cabinet IR (only while it is on)
+    auto tail = getLatencySamples() + juce::roundToInt (ampTailSeconds * getSampleRate());
+
+    if (static_cast<int> (cabinetParameter->load()) != 0)
+        tail += cabinet.getTailLength();
+
+    return tail;
+}
+
+int ClaudeAmpProcessor::getSilenceSkipSamples() const noexcept
+{
+    // The sag makes no sound of its own, so it is not part of the reported tail,
+    // but the next note would hear it if it were cut off early
+    return juce::jmax (getTailLengthSamples(), juce::roundToInt (sagSettleSeconds * getSampleRate()));
+}
+
+void ClaudeAmpProcessor::skipSilence (int numSamples) noexcept
+{
+    // By now the sag is within float precision of rest. Putting it exactly at
+    // rest means a skipped stretch leaves no trace, however the host splits it
+    auto numOversampledSamples = static_cast<size_t> (numSamples) * oversampler->getOversamplingFactor();
+
+    for (auto voicing : { PlexiVoicing::Voicing::normal, PlexiVoicing::Voicing::bright, PlexiVoicing::Voicing::link })
+    {
+        visitVariant (voicing, [numOversampledSamples] (auto& variant)
         {
-            rms += data[sample] * data[sample];
-        }
+            variant.mono.template get<10>().skipSilence (numOversampledSamples);
+            variant.vector.template get<10>().skipSilence (numOversampledSamples);
+        });
     }
-    rms = std::sqrt (rms / (buffer.getNumSamples() * buffer.getNumChannels()));
+}
 
-    // Envelope follower with attack/release
-    const float attackCoeff = 0.999f;   // Slow attack (power supply droop)
-    const float releaseCoeff = 0.9995f; // Very slow release (capacitor discharge)
+bool ClaudeAmpProcessor::isSilent (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax (buffer.getReadPointer (channel), numSamples);
 
-    if (rms > sagEnvelope)
-        sagEnvelope = attackCoeff * sagEnvelope + (1.0f - attackCoeff) * rms;
-    else
-        sagEnvelope = releaseCoeff * sagEnvelope + (1.0f - releaseCoeff) * rms;
+        if (range.getStart() < -silenceThreshold || range.getEnd() > silenceThreshold)
+            return false;
+    }
+
+    return true;
+}
+
+int ClaudeAmpProcessor::getTrailingSilence (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+    auto silence = numSamples;
+
+    // Each channel only needs searching back as far as the latest loud sample found so far
+    for (int channel = 0; channel < numChannels && silence > 0; ++channel)
+    {
+        auto* data = buffer.getReadPointer (channel);
 
-    // Convert envelope to sag amount (0-1 range)
-    // More signal = more sag (power supply compression)
-    float sagAmount = std::tanh (sagEnvelope * 8.0f) * 0.4f;  // Max 40% sag
+        for (int run = 0; run < silence; ++run)
+        {
+            if (std::abs (data[numSamples - 1 - run]) > silenceThreshold)
+            {
+                silence = run;
+                break;
+            }
+        }
+    }
+
+    return silence;
+}
 
-    return sagAmount;
+bool ClaudeAmpProcessor::isSmoothing() const noexcept
+{
+    return driveSmoothed.isSmoothing() || bassSmoothed.isSmoothing()
+        || midSmoothed.isSmoothing() || trebleSmoothed.isSmoothing()
+        || presenceSmoothed.isSmoothing() || masterSmoothed.isSmoothing();
 }
 
 //==============================================================================
 bool ClaudeAmpProcessor::hasEditor() const
 {
+   #if CLAUDEAMP_HEADLESS
+    return false;
+   #else
     return true;
+   #endif
 }
 
 juce::AudioProcessorEditor* ClaudeAmpProcessor::createEditor()
 {
+   #if CLAUDEAMP_HEADLESS
+    return nullptr;
+   #else
     return new ClaudeAmpProcessorEditor (*this);
+   #endif
 }
 
 //==============================================================================
+namespace StateVersion
+{
+    // 1: "cabinet" became Off/Lite/Full (stored as 0/1 while it was a bool)
+    const juce::Identifier property ("stateVersion");
+    constexpr int current = 1;
+}
+
+namespace CabinetState
+{
+    // Properties on the APVTS state tree, so they are saved with the parameters
+    const juce::Identifier file ("cabinetFile");
+    const juce::Identifier minimumPhase ("cabinetMinimumPhase");
+    const juce::Identifier maximumLength ("cabinetMaximumLength");
+}
+
 void ClaudeAmpProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml (state.createXml());
-    copyXmlToBinary (*xml, destData);
+    BinaryState::Contents contents;
+    contents.stateVersion = StateVersion::current;
+    contents.numStoredParameters = BinaryState::numParameters;
+
+    for (size_t i = 0; i < stateParameterValues.size(); ++i)
+        contents.parameters[i] = stateParameterValues[i]->load();
+
+    contents.cabinetMinimumPhase = apvts.state.getProperty (CabinetState::minimumPhase, false);
+    contents.cabinetMaximumLengthSeconds = apvts.state.getProperty (CabinetState::maximumLength, 0.0);
+    contents.cabinetFile = apvts.state.getProperty (CabinetState::file).toString();
+
+    BinaryState::write (contents, destData);
 }
 
 void ClaudeAmpProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    BinaryState::Contents contents;
+
+    if (! BinaryState::read (data, sizeInBytes, contents))
+    {
+        setXmlStateInformation (data, sizeInBytes);
+        return;
+    }
+
+    // Binary state starts at StateVersion 1, so there is nothing to upgrade yet.
+    // Parameters a blob doesn't hold keep their current values, as with XML
+    for (int i = 0; i < contents.numStoredParameters; ++i)
+    {
+        auto* parameter = stateParameters[static_cast<size_t> (i)];
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (contents.parameters[i]));
+    }
+
+    apvts.state.setProperty (CabinetState::minimumPhase, contents.cabinetMinimumPhase, nullptr);
+    apvts.state.setProperty (CabinetState::maximumLength, contents.cabinetMaximumLengthSeconds, nullptr);
+
+    if (contents.cabinetFile.isEmpty())
+        apvts.state.removeProperty (CabinetState::file, nullptr);
+    else
+        apvts.state.setProperty (CabinetState::file, contents.cabinetFile, nullptr);
+
+    restoreCabinetFromState();
+}
+
+void ClaudeAmpProcessor::setXmlStateInformation (const void* data, int sizeInBytes)
+{
+    // State saved before the binary format: the APVTS tree as XML
     std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
 
-    if (xmlState != nullptr)
-        if (xmlState->hasTagName (apvts.state.getType()))
-            apvts.replaceState (juce::ValueTree::fromXml (*xmlState));
+    if (xmlState != nullptr && xmlState->hasTagName (apvts.state.getType()))
+    {
+        auto state = juce::ValueTree::fromXml (*xmlState);
+
+        // Saved while the cabinet was on/off: "on" is now Full, not Lite
+        if (static_cast<int> (state.getProperty (StateVersion::property, 0)) < 1)
+        {
+            auto cabinetParameter = state.getChildWithProperty ("id", "cabinet");
+
+            if (cabinetParameter.isValid() && static_cast<float> (cabinetParameter.getProperty ("value")) > 0.5f)
+                cabinetParameter.setProperty ("value", 2.0f, nullptr);
+        }
+
+        apvts.replaceState (state);
+        restoreCabinetFromState();
+    }
+}
+
+//==============================================================================
+// Cabinet IR
+
+bool ClaudeAmpProcessor::loadCabinetImpulseResponse (const juce::File& file)
+{
+    if (! cabinet.loadImpulseResponse (file))
+        return false;
+
+    apvts.state.setProperty (CabinetState::file, file.getFullPathName(), nullptr);
+    return true;
+}
+
+void ClaudeAmpProcessor::useBuiltInCabinet()
+{
+    cabinet.loadBuiltIn();
+    apvts.state.removeProperty (CabinetState::file, nullptr);
+}
+
+void ClaudeAmpProcessor::setCabinetOptions (const CabinetConvolution::Options& options)
+{
+    cabinet.setOptions (options);
+    apvts.state.setProperty (CabinetState::minimumPhase, options.minimumPhase, nullptr);
+    apvts.state.setProperty (CabinetState::maximumLength, options.maximumLengthSeconds, nullptr);
+}
+
+CabinetConvolution::Options ClaudeAmpProcessor::getCabinetOptions() const
+{
+    return cabinet.getOptions();
+}
+
+CabinetLiteModel::FitError ClaudeAmpProcessor::getCabinetLiteFitError() const
+{
+    return cabinet.getLiteFitError();
+}
+
+juce::File ClaudeAmpProcessor::getCabinetFile() const
+{
+    // The selection, which may still be loading (or missing on this machine)
+    auto path = apvts.state.getProperty (CabinetState::file).toString();
+    return juce::File::isAbsolutePath (path) ? juce::File (path) : juce::File();
+}
+
+void ClaudeAmpProcessor::restoreCabinetFromState()
+{
+    CabinetConvolution::Options options;
+    options.minimumPhase = apvts.state.getProperty (CabinetState::minimumPhase, false);
+    options.maximumLengthSeconds = apvts.state.getProperty (CabinetState::maximumLength, 0.0);
+    cabinet.setOptions (options);  // Unchanged options rebuild nothing
+
+    auto path = apvts.state.getProperty (CabinetState::file).toString();
+    auto file = juce::File::isAbsolutePath (path) ? juce::File (path) : juce::File();
+
+    // Most restores bring back the IR already in use (or on its way): leave it be
+    if (cabinet.isRequestedSource (file))
+        return;
+
+    if (file != juce::File() && cabinet.loadImpulseResponse (file))
+        return;
+
+    // A missing file falls back to the built-in IR but stays in the state,
+    // so the session finds it again on a machine that has it
+    if (! cabinet.isRequestedSource ({}))
+        cabinet.loadBuiltIn();
 }
 
 //==============================================================================
 // Preset Management
 
+const char* const ClaudeAmpProcessor::presetParameterIDs[numPresetControls]
+    { "channel", "link", "drive", "bass", "mid", "treble", "presence", "master" };
+
 void ClaudeAmpProcessor::initializeFactoryPresets()
 {
     // Preset 0: Clean
@@ -687,16 +1258,80 @@ void ClaudeAmpProcessor::loadPreset (int presetIndex)
         return;
 
     const auto& preset = factoryPresets[presetIndex];
+    const float values[numPresetControls] { static_cast<float> (preset.channel), preset.link ? 1.0f : 0.0f,
+                                            preset.drive, preset.bass, preset.mid, preset.treble,
+                                            preset.presence, preset.master };
+
+    // The snapshot holds each value as the parameter will store it, so the
+    // audio thread can tell when a parameter write has landed
+    PresetSnapshot snapshot;
+    snapshot.crossfade = presetCrossfade;
+
+    for (int i = 0; i < numPresetControls; ++i)
+    {
+        auto* parameter = apvts.getParameter (presetParameterIDs[i]);
+        snapshot.values[i] = parameter->convertFrom0to1 (parameter->convertTo0to1 (values[i]));
+    }
+
+    const juce::ScopedLock sl (presetWriteLock);
+
+    // The audio thread switches to the snapshot; the parameters follow for the host and editor
+    presetSnapshots.write (snapshot);
+
+    for (int i = 0; i < numPresetControls; ++i)
+    {
+        auto* parameter = apvts.getParameter (presetParameterIDs[i]);
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (values[i]));
+    }
+}
+
+bool ClaudeAmpProcessor::getPresetControls (float (&values)[numPresetControls]) noexcept
+{
+    for (int i = 0; i < numPresetControls; ++i)
+        values[i] = presetParameters[static_cast<size_t> (i)]->load();
+
+    // Checked after the loads: loadPreset() publishes before it writes any
+    // parameter, so a preset value read above always comes with its snapshot
+    PresetSnapshot preset;
+    auto arrived = presetSnapshots.read (preset);
+
+    if (arrived)
+    {
+        heldPreset = preset;
+
+        for (int i = 0; i < numPresetControls; ++i)
+        {
+            presetPickupValues[i] = values[i];
+            presetHeld[i] = true;
+        }
+
+        // Every smoother ramps to the preset over the same time, from where it is now
+        auto steps = preset.crossfade ? juce::roundToInt (presetCrossfadeSeconds * getSampleRate()) : 0;
+
+        for (auto* smoother : { &driveSmoothed, &bassSmoothed, &midSmoothed,
+                                &trebleSmoothed, &presenceSmoothed, &masterSmoothed })
+        {
+            auto current = smoother->getCurrentValue();
+            smoother->reset (steps);
+            smoother->setCurrentAndTargetValue (current);
+        }
+
+        presetGliding = true;
+    }
+
+    // Each control stays on the preset until its write lands, or anything else moves it
+    for (int i = 0; i < numPresetControls; ++i)
+    {
+        if (! presetHeld[i])
+            continue;
+
+        if (values[i] == heldPreset.values[i] || values[i] != presetPickupValues[i])
+            presetHeld[i] = false;
+        else
+            values[i] = heldPreset.values[i];
+    }
 
-    // Update all parameters
-    apvts.getParameter ("channel")->setValueNotifyingHost (static_cast<float> (preset.channel));
-    apvts.getParameter ("link")->setValueNotifyingHost (preset.link ? 1.0f : 0.0f);
-    apvts.getParameter ("drive")->setValueNotifyingHost (preset.drive / 10.0f);
-    apvts.getParameter ("bass")->setValueNotifyingHost (preset.bass / 10.0f);
-    apvts.getParameter ("mid")->setValueNotifyingHost (preset.mid / 10.0f);
-    apvts.getParameter ("treble")->setValueNotifyingHost (preset.treble / 10.0f);
-    apvts.getParameter ("presence")->setValueNotifyingHost (preset.presence / 10.0f);
-    apvts.getParameter ("master")->setValueNotifyingHost (preset.master / 10.0f);
+    return arrived;
 }
 
 //==============================================================================
@@ -3,8 +3,19 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 
+#include "AmpTelemetry.h"
+#include "BinaryState.h"
+#include "CabinetConvolution.h"
+#include "DspProfiler.h"
+#include "OversamplingQuality.h"
+#include "PlexiChain.h"
+#include "ToneStackModel.h"
+#include "TripleBuffer.h"
+
 //==============================================================================
-class ClaudeAmpProcessor final : public juce::AudioProcessor
+class ClaudeAmpProcessor final : public juce::AudioProcessor,
+                                 private juce::AudioProcessorValueTreeState::Listener,
+                                 private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -47,55 +58,229 @@ public:
     // Parameter management
     juce::AudioProcessorValueTreeState apvts;
 
+    // Cabinet IR selection (message thread). Loading happens in the background
+    // and the choice is saved with the plugin state
+    bool loadCabinetImpulseResponse (const juce::File& file);
+    void useBuiltInCabinet();
+    void setCabinetOptions (const CabinetConvolution::Options& options);
+    CabinetConvolution::Options getCabinetOptions() const;
+    juce::File getCabinetFile() const;
+
+    // Spectral error of the "Lite" cabinet against the full convolution
+    CabinetLiteModel::FitError getCabinetLiteFitError() const;
+
+    // How long the last prepareToPlay took, and whether it kept the existing DSP
+    struct PrepareStats
+    {
+        double milliseconds = 0.0;
+        bool warm = false;
+    };
+
+    PrepareStats getLastPrepareStats() const noexcept;
+
+    // Whether program changes glide to the new preset (on by default) or switch at once
+    void setPresetCrossfade (bool shouldCrossfade) noexcept   { presetCrossfade = shouldCrossfade; }
+    bool getPresetCrossfade() const noexcept                  { return presetCrossfade; }
+
+    // Levels, sag and tube clipping for the editor's meters (measured while enabled)
+    AmpTelemetry& getTelemetry() noexcept  { return telemetry; }
+
+   #if CLAUDEAMP_PROFILING
+    // Per-section DSP load counters (read by the editor's load overlay)
+    DspProfiler& getProfiler() noexcept  { return profiler; }
+   #endif
+
 private:
     //==============================================================================
     // Create parameter layout
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // Marshall Plexi amp modeling chain
-    using Filter = juce::dsp::ProcessorDuplicator<
-        juce::dsp::IIR::Filter<float>,
-        juce::dsp::IIR::Coefficients<float>>;
-
-    using PlexiChain = juce::dsp::ProcessorChain<
-        juce::dsp::Gain<float>,                    // 0: Input level (controlled by Drive)
-        juce::dsp::StateVariableTPTFilter<float>,  // 1: Channel brightness (Normal=10Hz, Bright=500Hz HPF)
-        Filter,                                     // 2: Pre-emphasis (+6dB @ 5kHz)
-        juce::dsp::Bias<float>,                    // 3: Asymmetric bias stage 1
-        juce::dsp::WaveShaper<float>,              // 4: Preamp stage 1 (12AX7)
-        juce::dsp::StateVariableTPTFilter<float>,  // 5: Coupling HPF 1
-        juce::dsp::Bias<float>,                    // 6: Asymmetric bias stage 2
-        juce::dsp::WaveShaper<float>,              // 7: Preamp stage 2 (12AX7)
-        juce::dsp::StateVariableTPTFilter<float>,  // 8: Coupling HPF 2
-        juce::dsp::Bias<float>,                    // 9: Asymmetric bias stage 3
-        juce::dsp::WaveShaper<float>,              // 10: Preamp stage 3 (12AX7)
-        Filter,                                     // 11: De-emphasis (-6dB @ 5kHz)
-        Filter,                                     // 12: Tone stack bass (low-shelf)
-        Filter,                                     // 13: Tone stack mid (peaking)
-        Filter,                                     // 14: Tone stack treble (high-shelf)
-        juce::dsp::WaveShaper<float>,              // 15: Power amp (EL34)
-        Filter,                                     // 16: Presence (high-shelf boost)
-        juce::dsp::FirstOrderTPTFilter<float>,     // 17: DC blocker
-        juce::dsp::Gain<float>                     // 18: Master volume
-    >;
-
-    PlexiChain plexiChain;
-
-    // 4x oversampling for anti-aliasing
+    // Amp chain (PlexiChain.h), as float for mono and with one input channel
+    // per SIMD lane for stereo, so both channels run through each stage in one pass
+    using VectorSample = juce::dsp::SIMDRegister<float>;
+
+    // One pair of chains per voicing. They run the same code: the voicing only
+    // picks the channel filter prepareVariant() sets up. What separate chains buy
+    // is that a channel/link change never redesigns a filter mid-stream and can
+    // crossfade from the old chain; the tube tables are shared between them
+    template <PlexiVoicing::Voicing voicing>
+    struct ChainVariant
+    {
+        PlexiChain<float> mono;            // Mono input, or dual-mono stereo input
+        PlexiChain<VectorSample> vector;   // Stereo input, channels interleaved in lanes
+    };
+
+    ChainVariant<PlexiVoicing::Voicing::normal> normalChains;
+    ChainVariant<PlexiVoicing::Voicing::bright> brightChains;
+    ChainVariant<PlexiVoicing::Voicing::link> linkChains;
+    bool useVectorChain = false;
+
+    // Calls function (variant) with the chains of a voicing
+    template <typename Function>
+    void visitVariant (PlexiVoicing::Voicing voicing, Function&& function);
+
+    // Dispatcher: a voicing change hands the chain state to the new variant,
+    // then runs both and crossfades (in the oversampled domain) from the old one
+    static constexpr double variantCrossfadeSeconds = 0.02;
+    PlexiVoicing::Voicing activeVoicing = PlexiVoicing::Voicing::normal, fadingVoicing = PlexiVoicing::Voicing::normal;
+    int variantFadeLength = 1, variantFadePosition = 1;
+    bool isFadingVariant() const noexcept   { return variantFadePosition < variantFadeLength; }
+    void startVariantFade (PlexiVoicing::Voicing voicing) noexcept;
+
+    // The amp runs on the input channels; a mono input is fanned out to both
+    // outputs before the cabinet
+    int numAmpChannels = 0;
+
+    // Stereo input with bit-identical channels runs through the mono chain. Chain
+    // state is handed over lane by lane whenever the path switches
+    bool processingDualMono = false;
+    static bool isDualMono (const juce::AudioBuffer<float>& buffer, int numSamples) noexcept;
+
+    // Oversampled signal interleaved into SIMD lanes for the vector chains
+    juce::HeapBlock<char> interleavedData;
+    juce::dsp::AudioBlock<VectorSample> interleavedBlock;
+
+    // The outgoing variant's output while a crossfade runs
+    juce::HeapBlock<char> monoFadeData, vectorFadeData;
+    juce::dsp::AudioBlock<float> monoFadeBlock;
+    juce::dsp::AudioBlock<VectorSample> vectorFadeBlock;
+
+    // Filter coefficients, shared by both chains
+    juce::dsp::IIR::Coefficients<float>::Ptr preEmphasisCoefficients, deEmphasisCoefficients;
+    juce::dsp::IIR::Coefficients<float>::Ptr presenceCoefficients;
+    float toneStackCoefficients[ToneStackModel::coefficientsPerToneStack] { 1.0f };  // Identity until prepared
+
+    template <typename Chain>
+    void prepareChain (Chain& chain, const juce::dsp::ProcessSpec& laneSpec);
+
+    template <PlexiVoicing::Voicing voicing>
+    void prepareVariant (ChainVariant<voicing>& variant, const juce::dsp::ProcessSpec& laneSpec);
+
+    template <typename Chain, typename SampleType>
+    void processChain (Chain& chain, juce::dsp::AudioBlock<SampleType> block, int numSamples) noexcept;
+
+    // Runs the active variant's chain (selected by getChain) on a block, and the
+    // outgoing one too while a crossfade is in progress
+    template <typename SampleType, typename GetChain>
+    void processVariants (juce::dsp::AudioBlock<SampleType> block, juce::dsp::AudioBlock<SampleType> fadeBlock,
+                          int numSamples, GetChain&& getChain) noexcept;
+
+    void initialiseTubeStages();
+
+    // Tone stack/presence coefficients at the oversampled rate (prepared in prepareToPlay)
+    ToneStackModel toneStackModel;
+
+    // Oversampling for anti-aliasing (1x/2x/4x/8x, IIR or linear-phase FIR)
     std::unique_ptr<juce::dsp::Oversampling<float>> oversampler;
 
-    // Look-up tables for tube saturation (more authentic than tanh)
-    juce::dsp::LookupTableTransform<float> tube12AX7LUT;  // Preamp tubes (asymmetric)
-    juce::dsp::LookupTableTransform<float> tubeEL34LUT;   // Power amp tube (symmetric)
+    // What the DSP was last built for. prepareToPlay keeps it all (a warm
+    // restart) while these match, reallocating only if the block size grew
+    struct PreparedConfiguration
+    {
+        double sampleRate = 0.0;
+        int numInputChannels = 0, numOutputChannels = 0;
+        size_t oversamplingStages = 0;
+        bool linearPhase = false;
+        bool antiderivative = false;
+
+        bool operator== (const PreparedConfiguration& other) const noexcept
+        {
+            return sampleRate == other.sampleRate
+                && numInputChannels == other.numInputChannels
+                && numOutputChannels == other.numOutputChannels
+                && oversamplingStages == other.oversamplingStages
+                && linearPhase == other.linearPhase
+                && antiderivative == other.antiderivative;
+        }
+    };
+
+    PreparedConfiguration preparedConfiguration;
+    int preparedBlockSize = 0;
+
+    std::atomic<double> lastPrepareMilliseconds { 0.0 };
+    std::atomic<bool> lastPrepareWasWarm { false };
 
-    // Cabinet IR convolution (Marshall 4x12)
-    juce::dsp::Convolution cabinetIR;
+    // Quality changes rebuild the oversampler and chain on the message thread
+    void parameterChanged (const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
 
-    // Power supply sag modeling
-    float sagEnvelope = 0.0f;  // Tracks signal level for sag
-    float calculatePowerSupplySag (const juce::AudioBuffer<float>& buffer);
+    // Cabinet IR convolution (built-in Marshall 4x12 or a user IR). Switching
+    // it on or off crossfades with the dry signal
+    CabinetConvolution cabinet;
+    void restoreCabinetFromState();
+
+    juce::AudioBuffer<float> cabinetDryBuffer;
+    CabinetConvolution::Mode cabinetMode = CabinetConvolution::Mode::full;
+    bool cabinetOn = false;
+    int cabinetFadeLength = 1, cabinetFadePosition = 1;
+
+    // Silence skipping: once the input has been silent for the whole tail and
+    // the power supply has recharged, the amp and cabinet are bypassed and the
+    // output is cleared. Their filters are left settled on silence and the sag
+    // at rest, so signal resumes as if they had kept running. Silence is
+    // counted from the last sample above the threshold, not from a block start
+    static constexpr float silenceThreshold = 6.0e-8f;  // Below one 24-bit LSB (-144 dBFS)
+    static constexpr double ampTailSeconds = 0.5;       // Decay of the 5 Hz DC blocker and coupling HPFs
+    static constexpr double sagSettleSeconds = 16.0 * PlexiStages::PowerStage<float>::releaseMilliseconds / 1000.0;  // Rail within float precision of 1
+    int silentSamples = 0;
+    int getTailLengthSamples() const noexcept;
+    int getSilenceSkipSamples() const noexcept;
+    void skipSilence (int numSamples) noexcept;
+    static bool isSilent (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+    static int getTrailingSilence (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+    // Meter telemetry. The tube stages count clipped samples only while it is
+    // active, which follows the editor enabling it at the next block
+    AmpTelemetry telemetry;
+    bool telemetryActive = false;
+    void setTelemetryActive (bool shouldBeActive) noexcept;
+    void publishTelemetry (const juce::AudioBuffer<float>& buffer, int numSamples, bool ampRan) noexcept;
 
     // Parameter smoothing (prevents audio clicks)
+    // While any value ramps, processBlock updates the stages every chunk of
+    // this many input samples instead of once per host block
+    static constexpr int smoothingChunkSize = PlexiVoicing::smoothingChunkSize;
+    template <typename Chain>
+    void updateSmoothedStages (Chain& chain) noexcept;
+    bool isSmoothing() const noexcept;
+
+    // The controls processBlock reads, typed, taken once per block through the
+    // cached parameter pointers. The first eight flags follow presetParameterIDs
+    struct Controls
+    {
+        enum Flags : juce::uint32
+        {
+            channelFlag  = 1 << 0,
+            linkFlag     = 1 << 1,
+            driveFlag    = 1 << 2,
+            bassFlag     = 1 << 3,
+            midFlag      = 1 << 4,
+            trebleFlag   = 1 << 5,
+            presenceFlag = 1 << 6,
+            masterFlag   = 1 << 7,
+            cabinetFlag  = 1 << 8,
+
+            smoothedFlags = driveFlag | bassFlag | midFlag | trebleFlag | presenceFlag | masterFlag,
+            toneStackFlags = bassFlag | midFlag | trebleFlag
+        };
+
+        int channel = 0;
+        bool link = false;
+        float drive = 0.0f, bass = 0.0f, mid = 0.0f, treble = 0.0f, presence = 0.0f, master = 0.0f;
+        int cabinet = 0;
+    };
+
+    Controls controls;
+    std::atomic<float>* cabinetParameter = nullptr;
+    juce::uint32 readControls() noexcept;  // Returns the flags of the controls that changed
+
+    // What the smoothed controls feed, recomputed only while staleControls
+    // flags one of its inputs: set when a control moves, cleared once its
+    // smoother has landed and the final value has been applied
+    juce::uint32 staleControls = 0;
+    float inputGain = 1.0f, masterGain = 1.0f;  // Set on every chain that runs
+    void updateDerivedControls() noexcept;
+
     juce::SmoothedValue<float> driveSmoothed;
     juce::SmoothedValue<float> bassSmoothed;
     juce::SmoothedValue<float> midSmoothed;
@@ -103,6 +288,13 @@ private:
     juce::SmoothedValue<float> presenceSmoothed;
     juce::SmoothedValue<float> masterSmoothed;
 
+    // Plugin state, saved in BinaryState's fixed layout. getStateInformation()
+    // reads the parameters through these instead of copying the whole tree;
+    // setStateInformation() still reads the XML saved by earlier versions
+    std::array<juce::RangedAudioParameter*, BinaryState::numParameters> stateParameters {};
+    std::array<std::atomic<float>*, BinaryState::numParameters> stateParameterValues {};
+    void setXmlStateInformation (const void* data, int sizeInBytes);
+
     // Preset management
     int currentPreset = 0;
     void loadPreset (int presetIndex);
@@ -122,6 +314,39 @@ private:
     };
     std::vector<PresetData> factoryPresets;
 
+    // Preset switching. loadPreset() publishes the whole preset as one snapshot
+    // before it sets the parameters one by one. getPresetControls() picks it up
+    // at a block boundary and holds each control at the preset's value until
+    // that parameter has changed (or already matches), so a half-applied preset
+    // is never heard. The controls glide to the preset together over
+    // presetCrossfadeSeconds, or jump with the crossfade off; channel and link
+    // changes crossfade chain variants as usual
+    static constexpr int numPresetControls = 8;
+    static constexpr double presetCrossfadeSeconds = 0.05;
+    static const char* const presetParameterIDs[numPresetControls];  // channel, link, drive ... master
+
+    struct PresetSnapshot
+    {
+        float values[numPresetControls] {};  // Parameter units, in presetParameterIDs order
+        bool crossfade = true;
+    };
+
+    TripleBuffer<PresetSnapshot> presetSnapshots;
+    juce::CriticalSection presetWriteLock;  // Hosts may switch programs from more than one thread (never the audio thread)
+    std::atomic<bool> presetCrossfade { true };
+
+    // Audio thread side
+    std::array<std::atomic<float>*, numPresetControls> presetParameters {};
+    PresetSnapshot heldPreset;
+    float presetPickupValues[numPresetControls] {};  // Raw values when the snapshot arrived
+    bool presetHeld[numPresetControls] {};
+    bool presetGliding = false;
+    bool getPresetControls (float (&values)[numPresetControls]) noexcept;  // True when a preset arrived
+
+   #if CLAUDEAMP_PROFILING
+    DspProfiler profiler;
+   #endif
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClaudeAmpProcessor)
 };
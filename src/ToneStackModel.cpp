@@ -0,0 +1,190 @@
+#include "ToneStackModel.h"
+
+#include <array>
+#include <complex>
+
+namespace
+{
+    void normalise (const std::array<float, 6>& raw, float* destination) noexcept
+    {
+        // raw = { b0, b1, b2, a0, a1, a2 }, same layout IIR::Coefficients keeps after assign()
+        auto a0Inverse = 1.0f / raw[3];
+        destination[0] = raw[0] * a0Inverse;
+        destination[1] = raw[1] * a0Inverse;
+        destination[2] = raw[2] * a0Inverse;
+        destination[3] = raw[4] * a0Inverse;
+        destination[4] = raw[5] * a0Inverse;
+    }
+
+    // Maps a 0-10 knob onto a grid axis, returning the lower node and the fraction above it
+    int getGridPosition (float knob, int numPoints, float& fraction) noexcept
+    {
+        auto position = juce::jlimit (0.0f, 10.0f, knob) * static_cast<float> (numPoints - 1) / 10.0f;
+        auto index = juce::jmin (static_cast<int> (position), numPoints - 2);
+        fraction = position - static_cast<float> (index);
+        return index;
+    }
+
+    //==============================================================================
+    // Marshall tone stack components: pots (treble, bass, mid), slope resistor, caps
+    constexpr double R1 = 220.0e3, R2 = 1.0e6, R3 = 25.0e3, R4 = 33.0e3;
+    constexpr double C1 = 500.0e-12, C2 = 22.0e-9, C3 = 22.0e-9;
+
+    /** Transfer function coefficients in ascending powers of s. */
+    struct Network
+    {
+        double numerator[4], denominator[4];
+    };
+
+    /** The tone stack for pot positions l (bass), m (mid) and t (treble), 0-1. */
+    Network getNetwork (double l, double m, double t) noexcept
+    {
+        Network n;
+        auto& b = n.numerator;
+        auto& a = n.denominator;
+
+        b[0] = 0.0;
+        b[1] = t * C1 * R1 + m * C3 * R3 + l * (C1 * R2 + C2 * R2) + (C1 * R3 + C2 * R3);
+        b[2] = t * (C1 * C2 * R1 * R4 + C1 * C3 * R1 * R4)
+             - m * m * (C1 * C3 * R3 * R3 + C2 * C3 * R3 * R3)
+             + m * (C1 * C3 * R1 * R3 + C1 * C3 * R3 * R3 + C2 * C3 * R3 * R3)
+             + l * (C1 * C2 * R1 * R2 + C1 * C2 * R2 * R4 + C1 * C3 * R2 * R4)
+             + l * m * (C1 * C3 * R2 * R3 + C2 * C3 * R2 * R3)
+             + (C1 * C2 * R1 * R3 + C1 * C2 * R3 * R4 + C1 * C3 * R3 * R4);
+        b[3] = C1 * C2 * C3 * (l * m * (R1 * R2 * R3 + R2 * R3 * R4)
+                               - m * m * (R1 * R3 * R3 + R3 * R3 * R4)
+                               + m * (R1 * R3 * R3 + R3 * R3 * R4)
+                               + t * R1 * R3 * R4 - t * m * R1 * R3 * R4
+                               + t * l * R1 * R2 * R4);
+
+        a[0] = 1.0;
+        a[1] = (C1 * R1 + C1 * R3 + C2 * R3 + C2 * R4 + C3 * R4) + m * C3 * R3 + l * (C1 * R2 + C2 * R2);
+        a[2] = m * (C1 * C3 * R1 * R3 - C2 * C3 * R3 * R4 + C1 * C3 * R3 * R3 + C2 * C3 * R3 * R3)
+             + l * m * (C1 * C3 * R2 * R3 + C2 * C3 * R2 * R3)
+             - m * m * (C1 * C3 * R3 * R3 + C2 * C3 * R3 * R3)
+             + l * (C1 * C2 * R2 * R4 + C1 * C2 * R1 * R2 + C1 * C3 * R2 * R4 + C2 * C3 * R2 * R4)
+             + (C1 * C2 * R1 * R4 + C1 * C3 * R1 * R4 + C1 * C2 * R3 * R4
+                + C1 * C2 * R1 * R3 + C1 * C3 * R3 * R4 + C2 * C3 * R3 * R4);
+        a[3] = C1 * C2 * C3 * (l * m * (R1 * R2 * R3 + R2 * R3 * R4)
+                               - m * m * (R1 * R3 * R3 + R3 * R3 * R4)
+                               + m * (R3 * R3 * R4 + R1 * R3 * R3 - R1 * R3 * R4)
+                               + l * R1 * R2 * R4 + R1 * R3 * R4);
+        return n;
+    }
+
+    /** The bass pot is audio taper; it never quite reaches zero, which keeps
+        the network third order (a3 > 0) at every setting.
+    */
+    double getBassPosition (float bass) noexcept
+    {
+        return std::exp (3.4 * (juce::jlimit (0.0f, 10.0f, bass) / 10.0 - 1.0));
+    }
+
+    /** Roots of the denominator cubic. An RC network has real, negative,
+        distinct poles, so the trigonometric form applies; the roots come out
+        nearest to DC first, an order that holds as the knobs move.
+    */
+    void getPoles (const double (&a)[4], double (&poles)[3]) noexcept
+    {
+        auto A = a[2] / a[3], B = a[1] / a[3], C = a[0] / a[3];
+        auto p = B - A * A / 3.0;
+        auto q = 2.0 * A * A * A / 27.0 - A * B / 3.0 + C;
+        auto r = std::sqrt (juce::jmax (0.0, -p / 3.0));
+        auto phi = std::acos (juce::jlimit (-1.0, 1.0, 1.5 * q / (p * r))) / 3.0;
+
+        for (int k = 0; k < 3; ++k)
+            poles[k] = 2.0 * r * std::cos (phi - juce::MathConstants<double>::twoPi * k / 3.0) - A / 3.0;
+    }
+
+    /** Scales the network so it passes 1 kHz at unity with every knob at 5, as
+        the post-tone-stack gain staging expects. The passive stack loses
+        around 7.5 dB there; the knob interaction is left as it is.
+    */
+    const double makeupGain = []
+    {
+        auto network = getNetwork (getBassPosition (5.0f), 0.5, 0.5);
+        auto s = std::complex<double> (0.0, juce::MathConstants<double>::twoPi * 1000.0);
+        auto evaluate = [s] (const double (&c)[4]) { return ((c[3] * s + c[2]) * s + c[1]) * s + c[0]; };
+        return 1.0 / std::abs (evaluate (network.numerator) / evaluate (network.denominator));
+    }();
+}
+
+//==============================================================================
+void ToneStackModel::prepare (double sampleRate)
+{
+    if (sampleRate == preparedSampleRate)
+        return;
+
+    presenceNodes.resize (static_cast<size_t> (numPresencePoints));
+
+    for (int p = 0; p < numPresencePoints; ++p)
+        presenceNodes[static_cast<size_t> (p)] = designPresence (
+            sampleRate, static_cast<float> (p) * 10.0f / static_cast<float> (numPresencePoints - 1));
+
+    preparedSampleRate = sampleRate;
+}
+
+//==============================================================================
+void ToneStackModel::getToneStack (float bass, float mid, float treble, float* toneStackCoefficients) const noexcept
+{
+    jassert (preparedSampleRate > 0.0);
+
+    auto network = getNetwork (getBassPosition (bass), juce::jlimit (0.0f, 10.0f, mid) / 10.0,
+                               juce::jlimit (0.0f, 10.0f, treble) / 10.0);
+    const auto& b = network.numerator;
+    const auto& a = network.denominator;
+
+    double poles[3];
+    getPoles (a, poles);
+
+    // H(s) = b3/a3 + sum of r / (s - p). The bilinear transform (c = 2 fs) takes
+    // each fraction to (r / (c - p)) (1 + z^-1) / (1 - ((c + p) / (c - p)) z^-1)
+    auto c = 2.0 * preparedSampleRate;
+    toneStackCoefficients[0] = static_cast<float> (makeupGain * b[3] / a[3]);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto p = poles[i];
+        auto numerator = ((b[3] * p + b[2]) * p + b[1]) * p;
+        auto derivative = a[3];
+
+        for (int j = 0; j < 3; ++j)
+            if (j != i)
+                derivative *= p - poles[j];
+
+        auto residue = numerator / derivative;
+        toneStackCoefficients[1 + 2 * i] = static_cast<float> (makeupGain * residue / (c - p));
+        toneStackCoefficients[2 + 2 * i] = static_cast<float> ((c + p) / (c - p));
+    }
+}
+
+void ToneStackModel::getPresence (float presence, float* presenceCoefficients) const noexcept
+{
+    jassert (! presenceNodes.empty());
+
+    float fraction;
+    auto p = getGridPosition (presence, numPresencePoints, fraction);
+
+    const auto& lower = presenceNodes[static_cast<size_t> (p)];
+    const auto& upper = presenceNodes[static_cast<size_t> (p + 1)];
+
+    for (int i = 0; i < coefficientsPerFilter; ++i)
+        presenceCoefficients[i] = lower.coefficients[i]
+                                + fraction * (upper.coefficients[i] - lower.coefficients[i]);
+}
+
+//==============================================================================
+// Presence control: Broad high-frequency boost starting at 1kHz
+// Models negative feedback reduction (not simple high-shelf)
+// Real Plexi presence affects 1kHz+ with broad, gentle boost
+ToneStackModel::PresenceNode ToneStackModel::designPresence (double sampleRate, float presence)
+{
+    PresenceNode node;
+
+    auto presenceGainDB = presence * 0.8f;  // 0→0dB, 5→+4dB, 10→+8dB (conservative)
+    auto presenceGain = juce::Decibels::decibelsToGain (presenceGainDB);
+    normalise (juce::dsp::IIR::ArrayCoefficients<float>::makeHighShelf (sampleRate, 1200.0f, 0.5f, presenceGain),
+               node.coefficients);  // Start at 1.2kHz, broad Q
+
+    return node;
+}
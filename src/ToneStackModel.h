@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    Coefficients for the tone stack and presence filters.
+
+    The tone stack is the passive Marshall network (33k slope resistor, 500p
+    treble cap, 22n bass and mid caps, 220k/1M/25k pots). Its transfer
+    function is third order, with every s-domain coefficient a polynomial in
+    the three pot positions (Yeh & Smith, "Discretization of the '59 Fender
+    Bassman tone stack"), so the knobs interact the way the circuit does.
+    getToneStack() evaluates it in closed form on every call: the three real
+    poles come from the trigonometric solution of the denominator cubic, and
+    each partial fraction goes through the bilinear transform on its own.
+    The result is a direct path plus three first-order sections in parallel,
+    which stays accurate in float at 8x oversampling where a third-order
+    direct form loses the lowest pole.
+
+    Presence only scales a fixed high-shelf, so it gets a 1D table, built in
+    prepare() at the oversampled rate. Nothing here allocates after prepare().
+*/
+class ToneStackModel
+{
+public:
+    //==============================================================================
+    static constexpr int numPresencePoints        = 41; // Presence axis (0-10)
+    static constexpr int coefficientsPerFilter    = 5;  // b0, b1, b2, a1, a2 (a0 normalised)
+    static constexpr int coefficientsPerToneStack = 7;  // Direct gain, then gain and pole of each section
+
+    /** Builds the presence table for a sample rate. Not realtime safe. */
+    void prepare (double sampleRate);
+
+    /** Writes the tone stack's coefficients for the knob settings (0-10), in
+        the layout PlexiStages::ToneStack reads. The destination must hold
+        coefficientsPerToneStack floats.
+    */
+    void getToneStack (float bass, float mid, float treble, float* toneStackCoefficients) const noexcept;
+
+    /** Writes interpolated coefficients for the presence shelf. */
+    void getPresence (float presence, float* presenceCoefficients) const noexcept;
+
+private:
+    //==============================================================================
+    struct PresenceNode
+    {
+        float coefficients[coefficientsPerFilter];
+    };
+
+    static PresenceNode designPresence (double sampleRate, float presence);
+
+    std::vector<PresenceNode> presenceNodes;
+    double preparedSampleRate = 0.0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+
+//==============================================================================
+/**
+    Hands the newest value of a trivially copyable type from one writer thread
+    to one reader thread, whole.
+
+    Three slots rotate through a single atomic index: the writer fills its own
+    slot and swaps it into the middle, the reader swaps the middle out for its
+    own. Neither side ever waits for the other or allocates, and the reader
+    only ever sees complete values. Values written between two reads are
+    dropped in favour of the newest. With more than one writer, the callers
+    must serialise write() themselves.
+*/
+template <typename Value>
+class TripleBuffer
+{
+public:
+    //==============================================================================
+    /** Publishes a value (writer thread). */
+    void write (const Value& value) noexcept
+    {
+        slots[writeIndex] = value;
+        writeIndex = middle.exchange (writeIndex | freshFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    /** Copies the newest value into destination and returns true if one was
+        written since the last read (reader thread).
+    */
+    bool read (Value& destination) noexcept
+    {
+        if ((middle.load (std::memory_order_acquire) & freshFlag) == 0)
+            return false;
+
+        readIndex = middle.exchange (readIndex, std::memory_order_acq_rel) & indexMask;
+        destination = slots[readIndex];
+        return true;
+    }
+
+private:
+    //==============================================================================
+    static constexpr int indexMask = 3, freshFlag = 4;
+
+    Value slots[3] {};
+    std::atomic<int> middle { 1 };
+    int writeIndex = 0, readIndex = 2;
+};
@@ -0,0 +1,207 @@
+#include "TubeShaper.h"
+
+//==============================================================================
+// Reference transfer curves (the original per-sample WaveShaper lambdas)
+
+namespace
+{
+    float preampStage1Function (float x)
+    {
+        // 12AX7 first stage: soft overdrive, grid current compression
+        // Amplify significantly before saturation
+        x = x * 40.0f;  // Stage gain (~32dB, representing 12AX7 amplification)
+
+        // Grid conduction and asymmetric clipping
+        if (x > 1.2f)
+            return 1.0f;  // Hard clipping (grid conduction)
+        else if (x > 0.0f)
+            return x / (1.0f + std::pow (x * 1.5f, 2.5f));  // Asymmetric soft-knee
+        else if (x > -1.5f)
+            return x / (1.0f + std::pow (-x * 0.8f, 2.0f));  // Softer negative
+        else
+            return -0.95f;  // Grid cutoff
+    }
+
+    float preampStage2Function (float x)
+    {
+        // 12AX7 second stage: harder overdrive
+        x = x * 35.0f;  // Stage gain (~31dB)
+
+        // Harder clipping than stage 1
+        if (x > 1.0f)
+            return 0.98f;
+        else if (x > 0.0f)
+            return x / (1.0f + std::pow (x * 2.0f, 2.2f));  // Harder asymmetric
+        else if (x > -1.2f)
+            return x / (1.0f + std::pow (-x * 1.2f, 2.0f));
+        else
+            return -0.92f;
+    }
+
+    float preampStage3Function (float x)
+    {
+        // 12AX7 third stage: most aggressive
+        x = x * 25.0f;  // Stage gain (~28dB)
+
+        // Very aggressive clipping
+        if (x > 0.8f)
+            return 0.95f;
+        else if (x > 0.0f)
+            return x / (1.0f + std::pow (x * 2.5f, 2.0f));  // Hard asymmetric
+        else if (x > -1.0f)
+            return x / (1.0f + std::pow (-x * 1.5f, 1.8f));
+        else
+            return -0.90f;
+    }
+
+    float powerAmpFunction (float x)
+    {
+        // EL34 power tube stage gain (~25dB, representing phase inverter + power amp)
+        x = x * 18.0f;  // ~25dB gain
+
+        // Symmetrical soft clipping (push-pull cancels even harmonics)
+        if (x > 1.5f)
+            return 0.95f;  // Soft limiting
+        else if (x < -1.5f)
+            return -0.95f;
+        else
+            return x / (1.0f + std::pow (std::abs (x) * 1.2f, 2.0f)) * std::copysign (1.0f, x);
+    }
+}
+
+const TubeShaper::Curve TubeShaper::preampStage1 { preampStage1Function, -1.5f / 40.0f, 1.2f / 40.0f };
+const TubeShaper::Curve TubeShaper::preampStage2 { preampStage2Function, -1.2f / 35.0f, 1.0f / 35.0f };
+const TubeShaper::Curve TubeShaper::preampStage3 { preampStage3Function, -1.0f / 25.0f, 0.8f / 25.0f };
+const TubeShaper::Curve TubeShaper::powerAmp     { powerAmpFunction,     -1.5f / 18.0f, 1.5f / 18.0f };
+
+//==============================================================================
+void TubeShaper::initialise (const Curve& curve, float bias, size_t numPoints)
+{
+    jassert (numPoints >= 2);
+
+    const juce::ScopedLock sl (tableCache->lock);
+
+    for (auto& cached : tableCache->tables)
+    {
+        if (cached->curve.function == curve.function && cached->curve.minInput == curve.minInput
+             && cached->curve.maxInput == curve.maxInput && cached->bias == bias && cached->values.size() == numPoints)
+        {
+            table = cached;
+            return;
+        }
+    }
+
+    table = createTable (curve, bias, numPoints);
+    tableCache->tables.push_back (table);
+}
+
+std::shared_ptr<const TubeShaper::Table> TubeShaper::createTable (const Curve& curve, float bias, size_t numPoints)
+{
+    auto table = std::make_shared<Table>();
+    table->curve = curve;
+    table->bias = bias;
+
+    auto& values = table->values;
+    auto& slopes = table->slopes;
+    auto& integrals = table->integrals;
+
+    // Table domain is the unclipped range of the curve, shifted by the bias
+    auto minInput = table->minInput = curve.minInput - bias;
+    auto maxInput = table->maxInput = curve.maxInput - bias;
+    auto lastIndex = table->lastIndex = static_cast<int> (numPoints) - 1;
+    auto scale = table->scale = static_cast<float> (lastIndex) / (maxInput - minInput);
+
+    auto transfer = [&curve, bias] (float x) { return curve.function (x + bias); };
+
+    const auto width = maxInput - minInput;
+    table->lowValue  = transfer (minInput - width);
+    table->highValue = transfer (maxInput + width);
+
+    values.resize (numPoints);
+    slopes.resize (numPoints);
+
+    // End points are sampled a hair inside the range so rounding of (x + bias)
+    // can never land them on the clipped side of a grid conduction step
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        auto position = juce::jlimit (1.0e-3f, static_cast<float> (lastIndex) - 1.0e-3f, static_cast<float> (i));
+        values[i] = transfer (minInput + position / scale);
+    }
+
+    for (size_t i = 0; i + 1 < numPoints; ++i)
+        slopes[i] = values[i + 1] - values[i];
+
+    slopes[numPoints - 1] = 0.0f;
+
+    // Antiderivative of the interpolated table: each cell adds its trapezoid
+    integrals.resize (numPoints);
+    integrals[0] = 0.0;
+
+    for (size_t i = 0; i + 1 < numPoints; ++i)
+        integrals[i + 1] = integrals[i] + (static_cast<double> (values[i]) + 0.5 * static_cast<double> (slopes[i])) / static_cast<double> (scale);
+
+    // Accuracy bound: compare against the reference curve inside every cell
+    const int pointsPerCell = 8;
+    auto kernel = table->getKernel();
+    auto maxError = 0.0f;
+
+    for (int i = 0; i < lastIndex; ++i)
+    {
+        for (int k = 0; k < pointsPerCell; ++k)
+        {
+            auto position = static_cast<float> (i) + (static_cast<float> (k) + 0.5f) / static_cast<float> (pointsPerCell);
+            auto x = minInput + position / scale;
+            maxError = juce::jmax (maxError, std::abs (kernel.processSample (x) - transfer (x)));
+        }
+    }
+
+    // 513 points keep all four Plexi stages around 1e-5 (-100 dB) of the reference
+    jassert (maxError < 1.0e-4f);
+    table->maxError = maxError;
+    return table;
+}
+
+//==============================================================================
+void TubeShaper::process (float* data, size_t numSamples, size_t numLanes) noexcept
+{
+    jassert (numLanes <= maxLanes && numSamples % numLanes == 0);
+
+    auto kernel = getKernel();
+    size_t i = 0;
+
+    if (clipCounting)
+        for (size_t j = 0; j < numSamples; ++j)
+            clippedSamples[j % numLanes] += (data[j] > kernel.maxInput || data[j] < kernel.minInput) ? 1 : 0;
+
+    if (antiderivative)
+    {
+        for (; i < numSamples; i += numLanes)
+        {
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                auto x = data[i + lane];
+                data[i + lane] = kernel.processAntiderivative (x, previousInputs[lane]);
+                previousInputs[lane] = x;
+            }
+        }
+
+        return;
+    }
+
+   #if JUCE_USE_SIMD
+    using Vec = juce::dsp::SIMDRegister<float>;
+    constexpr auto vectorSize = Vec::size();
+
+    // Scalar run-in up to the first vector-aligned sample
+    auto numUnaligned = juce::jmin (static_cast<size_t> (Vec::getNextSIMDAlignedPtr (data) - data), numSamples);
+
+    for (; i < numUnaligned; ++i)
+        data[i] = kernel.processSample (data[i]);
+
+    for (; i + vectorSize <= numSamples; i += vectorSize)
+        kernel.processSample (Vec::fromRawArray (data + i)).copyToRawArray (data + i);
+   #endif
+
+    for (; i < numSamples; ++i)
+        data[i] = kernel.processSample (data[i]);
+}
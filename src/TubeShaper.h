@@ -0,0 +1,400 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+#include <numeric>
+
+//==============================================================================
+/**
+    Table-driven tube saturation stage.
+
+    Replaces a juce::dsp::WaveShaper running a std::pow-based lambda. The
+    transfer curve is sampled once, with the stage gain and the preceding bias
+    offset folded into the table, over the input range where the curve is not
+    clipped. Outside that range the curve's clip levels are returned exactly,
+    so the hard grid conduction/cutoff steps are not smeared by interpolation.
+
+    Blocks are evaluated with juce::dsp::SIMDRegister: the table position,
+    interpolation and clip selection run in vector registers, only the table
+    fetch is done per lane. The curve is memoryless, so blocks of interleaved
+    SIMDRegister<float> samples are shaped as one flat run of floats.
+
+    A table depends only on its curve, bias and size, so shapers built with
+    the same ones share it: the processor's chains and a bank's groups all
+    look up the same four tables, built once per process.
+
+    The antiderivative mode trades that for anti-aliasing (first-order ADAA):
+    each output is the mean of the curve between the previous input and the
+    current one, from the exact antiderivative of the interpolated table. The
+    clipping steps and knees then alias far less at a low oversampling factor,
+    for half a sample of delay and one stored input per lane.
+*/
+class TubeShaper
+{
+public:
+    //==============================================================================
+    /** Reference transfer curve of one tube stage. */
+    struct Curve
+    {
+        float (*function) (float);  // Original transfer function (stage gain included)
+        float minInput;             // Below this the function returns a constant
+        float maxInput;             // Above this the function returns a constant
+    };
+
+    static const Curve preampStage1;  // 12AX7, ~32dB stage gain
+    static const Curve preampStage2;  // 12AX7, ~31dB stage gain
+    static const Curve preampStage3;  // 12AX7, ~28dB stage gain
+    static const Curve powerAmp;      // EL34 push-pull, ~25dB stage gain
+
+    //==============================================================================
+    /** Sets up the table for a curve, with a bias offset added before the
+        curve: the shared one if another shaper built it already, otherwise a
+        new one. An odd number of points puts a grid point on the centre of a
+        symmetric curve. Not realtime safe (locks, may allocate).
+    */
+    void initialise (const Curve& curve, float bias, size_t numPoints = 513);
+
+    /** Largest absolute difference between the table and the reference curve,
+        measured when the table was built.
+    */
+    float getMaxError() const noexcept              { return table->maxError; }
+
+    //==============================================================================
+    /** The table and its limits as locals, for loops that run several stages
+        per sample (the arrays are referenced, not copied). A SIMDRegister<float>
+        sample is shaped lane by lane, each lane exactly as the float version.
+    */
+    struct Kernel
+    {
+        const float* values;
+        const float* slopes;
+        float minInput, maxInput, scale;
+        float lowValue, highValue;
+        int lastIndex;
+        const double* integrals;
+
+        float processSample (float x) const noexcept
+        {
+            // Written so a NaN input takes the low value rather than an index
+            if (x > maxInput)        return highValue;
+            if (! (x >= minInput))   return lowValue;
+
+            auto position = (x - minInput) * scale;
+            auto index = juce::jmin (static_cast<int> (position), lastIndex);
+            return values[(size_t) index] + slopes[(size_t) index] * (position - static_cast<float> (index));
+        }
+
+       #if JUCE_USE_SIMD
+        juce::dsp::SIMDRegister<float> processSample (juce::dsp::SIMDRegister<float> x) const noexcept
+        {
+            using Vec = juce::dsp::SIMDRegister<float>;
+            constexpr auto numLanes = Vec::size();
+
+            // Lanes below the table (NaN included, as in the scalar path) look
+            // up cell 0 and are replaced by the low value at the end
+            auto above = Vec::greaterThan (x, Vec::expand (maxInput));
+            auto below = ~Vec::greaterThanOrEqual (x, Vec::expand (minInput));
+
+            // Position, interpolation and clipping in vector registers; only the fetch is per lane
+            auto position = Vec::min (((x - Vec::expand (minInput)) * Vec::expand (scale)) & ~below,
+                                      Vec::expand (static_cast<float> (lastIndex)));
+            auto cell = Vec::truncate (position);
+            auto fraction = position - cell;
+
+            alignas (sizeof (Vec)) float base[numLanes];
+            alignas (sizeof (Vec)) float slope[numLanes];
+
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                auto index = static_cast<size_t> (cell.get (lane));
+                base[lane]  = values[index];
+                slope[lane] = slopes[index];
+            }
+
+            auto y = Vec::multiplyAdd (Vec::fromRawArray (base), Vec::fromRawArray (slope), fraction);
+
+            return (y & ~(above | below)) + (Vec::expand (highValue) & above) + (Vec::expand (lowValue) & below);
+        }
+       #endif
+
+        /** Mean of the curve between previous and x: (F (x) - F (previous)) / (x - previous). */
+        float processAntiderivative (float x, float previous) const noexcept
+        {
+            auto cell = getCell (x), previousCell = getCell (previous);
+
+            // Within one linear piece (or clipped region) the mean is the value at the midpoint
+            if (cell == previousCell)
+                return processSample (0.5f * (x + previous));
+
+            // Otherwise partial cells at both ends plus whole cells in between, each
+            // summed on its own so that inputs close together do not cancel
+            auto low = x, high = previous;
+            auto lowCell = cell, highCell = previousCell;
+
+            if (cell > previousCell)
+            {
+                std::swap (low, high);
+                std::swap (lowCell, highCell);
+            }
+
+            auto area = getAreaToCellEnd (low, lowCell)
+                      + (integrals[highCell] - integrals[lowCell + 1])
+                      + getAreaFromCellStart (high, highCell);
+
+            return static_cast<float> (area / (static_cast<double> (high) - static_cast<double> (low)));
+        }
+
+       #if JUCE_USE_SIMD
+        juce::dsp::SIMDRegister<float> processAntiderivative (juce::dsp::SIMDRegister<float> x,
+                                                              juce::dsp::SIMDRegister<float> previous) const noexcept
+        {
+            juce::dsp::SIMDRegister<float> y;
+
+            for (size_t lane = 0; lane < juce::dsp::SIMDRegister<float>::size(); ++lane)
+                y.set (lane, processAntiderivative (x.get (lane), previous.get (lane)));
+
+            return y;
+        }
+       #endif
+
+    private:
+        // -1 below the table (or NaN), lastIndex above it, otherwise the table cell
+        int getCell (float x) const noexcept
+        {
+            if (x > maxInput)        return lastIndex;
+            if (! (x >= minInput))   return -1;
+
+            return juce::jmin (static_cast<int> ((x - minInput) * scale), lastIndex - 1);
+        }
+
+        double getPosition (float x, int cell) const noexcept
+        {
+            return (static_cast<double> (x) - static_cast<double> (minInput)) * static_cast<double> (scale) - cell;
+        }
+
+        double getAreaToCellEnd (float x, int cell) const noexcept
+        {
+            if (cell < 0)
+                return static_cast<double> (lowValue) * (static_cast<double> (minInput) - static_cast<double> (x));
+
+            auto t = getPosition (x, cell);
+            auto value = static_cast<double> (values[cell]), slope = static_cast<double> (slopes[cell]);
+            return (1.0 - t) * (value + slope * 0.5 * (1.0 + t)) / static_cast<double> (scale);
+        }
+
+        double getAreaFromCellStart (float x, int cell) const noexcept
+        {
+            if (cell >= lastIndex)
+                return static_cast<double> (highValue) * (static_cast<double> (x) - static_cast<double> (maxInput));
+
+            auto t = getPosition (x, cell);
+            auto value = static_cast<double> (values[cell]), slope = static_cast<double> (slopes[cell]);
+            return t * (value + slope * 0.5 * t) / static_cast<double> (scale);
+        }
+    };
+
+    /** Kernel of the antiderivative mode, with the previous input of every lane. */
+    template <typename SampleType>
+    struct AntiderivativeKernel
+    {
+        Kernel kernel;
+        SampleType previous;
+
+        SampleType processSample (SampleType x) noexcept
+        {
+            auto y = kernel.processAntiderivative (x, previous);
+            previous = x;
+            return y;
+        }
+    };
+
+    /** Wraps a table or antiderivative kernel and counts, lane by lane, the
+        samples that arrive past the table's ends, where the curve clips.
+    */
+    template <typename InnerKernel, typename SampleType>
+    struct ClipCountingKernel
+    {
+        InnerKernel inner;
+        float minInput, maxInput;
+        SampleType clipped;  // Count per lane, added up by setState()
+
+        SampleType processSample (SampleType x) noexcept
+        {
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                clipped += (x > maxInput || x < minInput) ? 1.0f : 0.0f;
+            }
+            else
+            {
+                auto outside = SampleType::greaterThan (x, SampleType::expand (maxInput))
+                             | SampleType::lessThan (x, SampleType::expand (minInput));
+                clipped = clipped + (SampleType::expand (1.0f) & outside);
+            }
+
+            return inner.processSample (x);
+        }
+    };
+
+    Kernel getKernel() const noexcept
+    {
+        jassert (table != nullptr);
+        return table->getKernel();
+    }
+
+    template <typename SampleType>
+    AntiderivativeKernel<SampleType> getAntiderivativeKernel() const noexcept
+    {
+        AntiderivativeKernel<SampleType> kernel { getKernel(), SampleType (0.0f) };
+
+        if constexpr (std::is_same_v<SampleType, float>)
+            kernel.previous = previousInputs[0];
+        else
+            for (size_t lane = 0; lane < SampleType::size(); ++lane)
+                kernel.previous.set (lane, previousInputs[lane]);
+
+        return kernel;
+    }
+
+    template <typename SampleType, typename InnerKernel>
+    ClipCountingKernel<InnerKernel, SampleType> getClipCountingKernel (const InnerKernel& inner) const noexcept
+    {
+        return { inner, table->minInput, table->maxInput, SampleType (0.0f) };
+    }
+
+    void setState (const Kernel&) noexcept  {}
+
+    template <typename SampleType>
+    void setState (const AntiderivativeKernel<SampleType>& kernel) noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            previousInputs[0] = kernel.previous;
+        else
+            for (size_t lane = 0; lane < SampleType::size(); ++lane)
+                previousInputs[lane] = kernel.previous.get (lane);
+    }
+
+    template <typename InnerKernel, typename SampleType>
+    void setState (const ClipCountingKernel<InnerKernel, SampleType>& kernel) noexcept
+    {
+        setState (kernel.inner);
+
+        if constexpr (std::is_same_v<SampleType, float>)
+            clippedSamples[0] += static_cast<int> (kernel.clipped);
+        else
+            for (size_t lane = 0; lane < SampleType::size(); ++lane)
+                clippedSamples[lane] += static_cast<int> (kernel.clipped.get (lane));
+    }
+
+    float processSample (float x) const noexcept    { return getKernel().processSample (x); }
+
+    /** Processes a run of numSamples floats in place: interleaved samples of
+        numLanes lanes each (only the antiderivative mode tells lanes apart).
+    */
+    void process (float* data, size_t numSamples, size_t numLanes = 1) noexcept;
+
+    //==============================================================================
+    /** Switches between the plain table and antiderivative anti-aliasing. */
+    void setAntiderivative (bool shouldUseAntiderivative) noexcept  { antiderivative = shouldUseAntiderivative; }
+    bool usesAntiderivative() const noexcept                         { return antiderivative; }
+
+    /** Counts samples driven into clipping, lane by lane (for metering; off by
+        default, as it costs a compare per sample).
+    */
+    void setClipCounting (bool shouldCount) noexcept   { clipCounting = shouldCount; }
+    bool countsClipping() const noexcept               { return clipCounting; }
+
+    /** Returns the samples clipped in the first numLanes lanes since the last
+        call, and starts a new count for every lane.
+    */
+    int takeClippedSamples (size_t numLanes) noexcept
+    {
+        auto total = std::accumulate (clippedSamples, clippedSamples + juce::jmin (numLanes, maxLanes), 0);
+        std::fill (std::begin (clippedSamples), std::end (clippedSamples), 0);
+        return total;
+    }
+
+    void prepare (const juce::dsp::ProcessSpec&) noexcept  { reset(); }
+    void reset() noexcept                                   { std::fill (std::begin (previousInputs), std::end (previousInputs), 0.0f); }
+
+    /** Copies one lane's previous input (antiderivative mode state). */
+    void copyLaneFrom (const TubeShaper& source, size_t sourceLane, size_t destinationLane) noexcept
+    {
+        previousInputs[destinationLane] = source.previousInputs[sourceLane];
+    }
+
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        using SampleType = typename ProcessContext::SampleType;
+        constexpr auto floatsPerSample = sizeof (SampleType) / sizeof (float);
+
+        auto&& inputBlock  = context.getInputBlock();
+        auto&& outputBlock = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+
+        if (context.usesSeparateInputAndOutputBlocks())
+            outputBlock.copyFrom (inputBlock);
+
+        if (context.isBypassed)
+            return;
+
+        // The antiderivative state is one input per lane, for a single channel
+        jassert (! antiderivative || outputBlock.getNumChannels() == 1);
+
+        for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
+            process (reinterpret_cast<float*> (outputBlock.getChannelPointer (channel)),
+                     outputBlock.getNumSamples() * floatsPerSample, floatsPerSample);
+    }
+
+private:
+    //==============================================================================
+    /** One curve's table. Never changes once built. */
+    struct Table
+    {
+        Curve curve;
+        float bias;
+
+        // Per-point value and slope to the next point, so a lookup is one fetch per array
+        std::vector<float> values, slopes;
+
+        // Antiderivative at every point (0 at minInput), in double so that the
+        // difference over a few cells keeps its precision
+        std::vector<double> integrals;
+
+        float minInput = 0.0f, maxInput = 0.0f, scale = 0.0f;
+        float lowValue = 0.0f, highValue = 0.0f;
+        float maxError = 0.0f;
+        int lastIndex = 0;
+
+        Kernel getKernel() const noexcept
+        {
+            return { values.data(), slopes.data(), minInput, maxInput, scale, lowValue, highValue, lastIndex, integrals.data() };
+        }
+    };
+
+    /** Every table built so far. Lives while any shaper does. */
+    struct TableCache
+    {
+        juce::CriticalSection lock;
+        std::vector<std::shared_ptr<const Table>> tables;
+    };
+
+    static std::shared_ptr<const Table> createTable (const Curve& curve, float bias, size_t numPoints);
+
+    std::shared_ptr<const Table> table;
+    juce::SharedResourcePointer<TableCache> tableCache;
+
+   #if JUCE_USE_SIMD
+    static constexpr size_t maxLanes = juce::dsp::SIMDRegister<float>::size();
+   #else
+    static constexpr size_t maxLanes = 1;
+   #endif
+
+    bool antiderivative = false;
+    float previousInputs[maxLanes] {};
+
+    bool clipCounting = false;
+    int clippedSamples[maxLanes] {};
+};
@@ -0,0 +1,699 @@
+#include "PluginProcessor.h"
+
+#include <iostream>
+#include <limits>
+#include <map>
+
+//==============================================================================
+/*
+    ClaudeAmpBatchRender
+
+    Reamps a list of WAV/AIFF files through ClaudeAmpProcessor, faster than
+    realtime and without an editor. Files are shared out across a pool of
+    worker threads; each worker owns one processor instance and reuses it for
+    every file it picks up.
+
+    With --split, long files are cut into segments instead, and every worker
+    renders segments of the same file. Each segment starts a pre-roll early,
+    so the amp's filters, oversampler, sag and cabinet settle on the signal
+    that precedes it; the pre-roll's output is discarded and the segments are
+    stitched back in order, sample for sample. What remains of the state the
+    serial render would have had decays with the pre-roll length; --verify
+    keeps the stitched output in memory as float, renders each file serially
+    as well and reports the largest difference, before the output file's
+    quantization and clipping can hide it.
+
+    Usage:
+        ClaudeAmpBatchRender [options] <input files...>
+
+    Options:
+        --preset <name>         Factory preset to start from (e.g. "Crunch")
+        --param <id>=<value>    Set a parameter, e.g. --param drive=7.5
+                                (repeatable, applied after --preset)
+        --output-dir <dir>      Where to write results (default: next to input)
+        --suffix <text>         Appended to output file names (default: "_ClaudeAmp")
+        --jobs <n>              Number of workers (default: number of CPU cores)
+        --block-size <n>        Samples per processBlock call (default: 8192)
+        --split                 Render each file as segments on all workers
+        --segment-seconds <s>   Segment length with --split (default: 30)
+        --preroll-seconds <s>   Pre-roll before each segment (default: 4x the
+                                amp's tail, at least 2 s)
+        --verify                With --split, also render serially and report
+                                the maximum deviation
+*/
+
+namespace
+{
+    struct RenderSettings
+    {
+        juce::String presetName;
+        juce::StringPairArray parameters;
+        juce::File outputDirectory;
+        juce::String suffix = "_ClaudeAmp";
+        int numJobs = juce::SystemStats::getNumCpus();
+        int blockSize = 8192;
+        juce::Array<juce::File> inputFiles;
+
+        bool split = false;
+        double segmentSeconds = 30.0;
+        double preRollSeconds = -1.0;  // Negative: from the amp's tail length
+        bool verify = false;
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: ClaudeAmpBatchRender [options] <input files...>\n"
+                     "  --preset <name>         Factory preset to start from\n"
+                     "  --param <id>=<value>    Set a parameter (repeatable)\n"
+                     "  --output-dir <dir>      Output directory (default: next to input)\n"
+                     "  --suffix <text>         Output file name suffix (default: _ClaudeAmp)\n"
+                     "  --jobs <n>              Number of worker threads\n"
+                     "  --block-size <n>        Samples per processBlock call (default: 8192)\n"
+                     "  --split                 Render each file as segments on all workers\n"
+                     "  --segment-seconds <s>   Segment length with --split (default: 30)\n"
+                     "  --preroll-seconds <s>   Pre-roll before each segment (default: from the amp's tail)\n"
+                     "  --verify                With --split, also render serially and report the deviation\n";
+    }
+
+    bool parseArguments (int argc, char* argv[], RenderSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            juce::String arg (argv[i]);
+            auto hasValue = i + 1 < argc;
+
+            if (arg == "--preset" && hasValue)
+                settings.presetName = argv[++i];
+            else if (arg == "--param" && hasValue)
+            {
+                juce::String assignment (argv[++i]);
+
+                if (! assignment.containsChar ('='))
+                {
+                    std::cerr << "Expected <id>=<value>, got: " << assignment << "\n";
+                    return false;
+                }
+
+                settings.parameters.set (assignment.upToFirstOccurrenceOf ("=", false, false).trim(),
+                                         assignment.fromFirstOccurrenceOf ("=", false, false).trim());
+            }
+            else if (arg == "--output-dir" && hasValue)
+                settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+            else if (arg == "--suffix" && hasValue)
+                settings.suffix = argv[++i];
+            else if (arg == "--jobs" && hasValue)
+                settings.numJobs = juce::jmax (1, juce::String (argv[++i]).getIntValue());
+            else if (arg == "--block-size" && hasValue)
+                settings.blockSize = juce::jmax (16, juce::String (argv[++i]).getIntValue());
+            else if (arg == "--split")
+                settings.split = true;
+            else if (arg == "--segment-seconds" && hasValue)
+                settings.segmentSeconds = juce::jmax (1.0, juce::String (argv[++i]).getDoubleValue());
+            else if (arg == "--preroll-seconds" && hasValue)
+                settings.preRollSeconds = juce::jmax (0.0, juce::String (argv[++i]).getDoubleValue());
+            else if (arg == "--verify")
+                settings.verify = true;
+            else if (arg.startsWith ("--"))
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << "\n";
+                return false;
+            }
+            else
+                settings.inputFiles.add (juce::File::getCurrentWorkingDirectory().getChildFile (arg));
+        }
+
+        return ! settings.inputFiles.isEmpty();
+    }
+
+    //==============================================================================
+    // Applies the preset, then individual parameter overrides, to one processor
+    bool applySettings (ClaudeAmpProcessor& processor, const RenderSettings& settings)
+    {
+        if (settings.presetName.isNotEmpty())
+        {
+            auto found = false;
+
+            for (int i = 0; i < processor.getNumPrograms(); ++i)
+            {
+                if (processor.getProgramName (i).equalsIgnoreCase (settings.presetName))
+                {
+                    processor.setCurrentProgram (i);
+                    found = true;
+                    break;
+                }
+            }
+
+            if (! found)
+            {
+                std::cerr << "Unknown preset: " << settings.presetName << "\n";
+                return false;
+            }
+        }
+
+        for (auto& id : settings.parameters.getAllKeys())
+        {
+            auto* parameter = processor.apvts.getParameter (id);
+
+            if (parameter == nullptr)
+            {
+                std::cerr << "Unknown parameter: " << id << "\n";
+                return false;
+            }
+
+            // Text conversion handles numbers as well as choice/bool names ("Bright", "off")
+            parameter->setValueNotifyingHost (parameter->getValueForText (settings.parameters[id]));
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    // Matches the processor's buses to a file and prepares it, which also clears
+    // all of its state. Returns an error, or an empty string
+    juce::String prepareProcessor (ClaudeAmpProcessor& processor, int numChannels, double sampleRate, int blockSize)
+    {
+        if (numChannels < 1 || numChannels > 2)
+            return "only mono and stereo files are supported";
+
+        juce::AudioProcessor::BusesLayout layout;
+        auto channelSet = juce::AudioChannelSet::canonicalChannelSet (numChannels);
+        layout.inputBuses.add (channelSet);
+        layout.outputBuses.add (channelSet);
+
+        if (! processor.setBusesLayout (layout))
+            return "unsupported channel layout";
+
+        processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+        return {};
+    }
+
+    // Pre-roll for --split, once the processor is prepared. The default covers
+    // the amp's filters, the sag release and the cabinet IR several times over
+    juce::int64 getPreRollSamples (const ClaudeAmpProcessor& processor, const RenderSettings& settings, double sampleRate)
+    {
+        auto seconds = settings.preRollSeconds >= 0.0 ? settings.preRollSeconds
+                                                     : juce::jmax (2.0, 4.0 * processor.getTailLengthSeconds());
+
+        return static_cast<juce::int64> (std::ceil (seconds * sampleRate));
+    }
+
+    // Renders input samples [start, end) of a file through a prepared processor.
+    // Latency compensation: output is taken latency samples later and zeros are
+    // flushed through past the end, so output sample n lines up with input
+    // sample n. Up to preRoll samples before start are processed first and
+    // their output dropped. Output goes to consume (buffer, startSample,
+    // numSamples) in order. Returns false if the thread was asked to exit
+    template <typename Consume>
+    bool renderRange (ClaudeAmpProcessor& processor, juce::AudioFormatReader& reader, int blockSize,
+                      juce::int64 start, juce::int64 end, juce::int64 preRoll, Consume&& consume)
+    {
+        auto numChannels = static_cast<int> (reader.numChannels);
+        auto latency = static_cast<juce::int64> (processor.getLatencySamples());
+        auto totalInput = reader.lengthInSamples;
+
+        auto position = juce::jmax (static_cast<juce::int64> (0), start - preRoll);
+        auto firstOutput = start + latency;
+        auto endPosition = end + latency;
+
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        while (position < endPosition)
+        {
+            auto numSamples = static_cast<int> (juce::jmin (static_cast<juce::int64> (blockSize),
+                                                            endPosition - position));
+            buffer.setSize (numChannels, numSamples, false, false, true);
+            buffer.clear();
+
+            if (position < totalInput)
+            {
+                auto numToRead = static_cast<int> (juce::jmin (static_cast<juce::int64> (numSamples),
+                                                               totalInput - position));
+                reader.read (&buffer, 0, numToRead, position, true, true);
+            }
+
+            processor.processBlock (buffer, midi);
+
+            // Skip output that is still inside the pre-roll or the latency window
+            auto skip = static_cast<int> (juce::jlimit (static_cast<juce::int64> (0),
+                                                        static_cast<juce::int64> (numSamples),
+                                                        firstOutput - position));
+
+            if (skip < numSamples)
+                consume (buffer, skip, numSamples - skip);
+
+            position += numSamples;
+
+            if (juce::Thread::currentThreadShouldExit())
+                return false;
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    // Output file for an input: same format and bit depth, named by the settings
+    struct RenderOutput
+    {
+        juce::File file;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        juce::String error;
+    };
+
+    RenderOutput createOutput (juce::AudioFormatManager& formatManager, const RenderSettings& settings,
+                               const juce::File& input, const juce::AudioFormatReader& reader)
+    {
+        RenderOutput output;
+
+        auto outputDirectory = settings.outputDirectory == juce::File() ? input.getParentDirectory()
+                                                                         : settings.outputDirectory;
+        output.file = outputDirectory.getChildFile (input.getFileNameWithoutExtension()
+                                                    + settings.suffix + input.getFileExtension());
+
+        auto* format = formatManager.findFormatForFileExtension (input.getFileExtension());
+
+        if (format == nullptr || ! (format->canDoMono() && format->canDoStereo()))
+        {
+            output.error = "unsupported output format";
+            return output;
+        }
+
+        output.file.deleteFile();
+        auto stream = output.file.createOutputStream();
+
+        if (stream == nullptr)
+        {
+            output.error = "could not create " + output.file.getFullPathName();
+            return output;
+        }
+
+        auto bitDepth = format->getPossibleBitDepths().contains (static_cast<int> (reader.bitsPerSample))
+                          ? static_cast<int> (reader.bitsPerSample) : 24;
+
+        output.writer.reset (format->createWriterFor (stream.get(), reader.sampleRate,
+                                                      reader.numChannels, bitDepth, {}, 0));
+        if (output.writer == nullptr)
+        {
+            output.error = "could not create writer";
+            return output;
+        }
+
+        stream.release();  // Owned by the writer now
+        return output;
+    }
+
+    //==============================================================================
+    // A file rendered with --split. Segments finish in any order, on any worker,
+    // and each is written as soon as every segment before it is. They are handed
+    // out in order and take about as long each, so only a few wait at a time
+    struct SplitFile
+    {
+        juce::File input, output;
+        int numChannels = 0;
+        double sampleRate = 0.0;
+        juce::int64 length = 0, segmentLength = 0;
+        int numSegments = 0;
+
+        juce::CriticalSection lock;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        std::map<int, juce::AudioBuffer<float>> pending;  // Rendered, waiting for an earlier segment
+        int numStitched = 0;
+        juce::String error;                               // The first failure, if any
+        double preRollSeconds = 0.0;
+
+        juce::AudioBuffer<float> stitched;                // With --verify: what was written, still as float
+    };
+
+    struct Segment
+    {
+        SplitFile* file;
+        int index;
+    };
+
+    // Renders a --split file serially and returns the largest difference from
+    // the float samples the segments produced, or a negative value if it could
+    // not be measured. Comparing before the writer quantizes to the file's bit
+    // depth (and clips) shows the stitching error itself, however small
+    float measureDeviation (ClaudeAmpProcessor& processor, juce::AudioFormatManager& formatManager,
+                            const SplitFile& file, int blockSize)
+    {
+        std::unique_ptr<juce::AudioFormatReader> input (formatManager.createReaderFor (file.input));
+
+        if (input == nullptr || file.stitched.getNumSamples() != file.length
+             || prepareProcessor (processor, file.numChannels, file.sampleRate, blockSize).isNotEmpty())
+            return -1.0f;
+
+        auto position = 0;
+        auto deviation = 0.0f;
+
+        renderRange (processor, *input, blockSize, 0, file.length, 0,
+                     [&] (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+                     {
+                         for (int channel = 0; channel < file.numChannels; ++channel)
+                         {
+                             auto* serial = buffer.getReadPointer (channel, startSample);
+                             auto* split = file.stitched.getReadPointer (channel, position);
+
+                             for (int i = 0; i < numSamples; ++i)
+                                 deviation = juce::jmax (deviation, std::abs (serial[i] - split[i]));
+                         }
+
+                         position += numSamples;
+                     });
+
+        processor.releaseResources();
+        return deviation;
+    }
+
+    //==============================================================================
+    class RenderWorker final : public juce::Thread
+    {
+    public:
+        RenderWorker (const RenderSettings& s, const std::vector<Segment>& segmentList, std::atomic<int>& next,
+                      juce::StringArray& log, juce::CriticalSection& logLock)
+            : juce::Thread ("ClaudeAmp render worker"),
+              settings (s), segments (segmentList), nextFile (next), results (log), resultsLock (logLock)
+        {
+            processor.setNonRealtime (true);
+            formatManager.registerBasicFormats();
+        }
+
+        bool configure()    { return applySettings (processor, settings); }
+        int getNumFailed() const noexcept   { return numFailed; }
+
+        void run() override
+        {
+            if (settings.split)
+            {
+                // nextFile counts segments instead
+                for (auto index = nextFile.fetch_add (1); index < static_cast<int> (segments.size()) && ! threadShouldExit();
+                     index = nextFile.fetch_add (1))
+                    renderSegment (segments[static_cast<size_t> (index)]);
+
+                return;
+            }
+
+            for (;;)
+            {
+                auto index = nextFile.fetch_add (1);
+
+                if (index >= settings.inputFiles.size() || threadShouldExit())
+                    break;
+
+                auto message = renderFile (settings.inputFiles.getReference (index));
+
+                const juce::ScopedLock sl (resultsLock);
+                results.add (message);
+            }
+        }
+
+    private:
+        //==============================================================================
+        juce::String renderFile (const juce::File& input)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (input));
+
+            if (reader == nullptr)
+                return fail (input, "could not open as audio");
+
+            auto sampleRate = reader->sampleRate;
+            auto error = prepareProcessor (processor, static_cast<int> (reader->numChannels), sampleRate, settings.blockSize);
+
+            if (error.isNotEmpty())
+                return fail (input, error);
+
+            auto output = createOutput (formatManager, settings, input, *reader);
+
+            if (output.writer == nullptr)
+                return fail (input, output.error);
+
+            auto totalInput = reader->lengthInSamples;
+            auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+            auto completed = renderRange (processor, *reader, settings.blockSize, 0, totalInput, 0,
+                                          [&] (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+                                          {
+                                              output.writer->writeFromAudioSampleBuffer (buffer, startSample, numSamples);
+                                          });
+
+            // Like a failed split render, a cancelled one leaves no partial file behind
+            if (! completed)
+            {
+                output.writer.reset();
+                output.file.deleteFile();
+                return fail (input, "cancelled");
+            }
+
+            processor.releaseResources();
+
+            auto seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+            auto audioSeconds = static_cast<double> (totalInput) / sampleRate;
+
+            return input.getFileName() + " -> " + output.file.getFullPathName()
+                 + " (" + juce::String (audioSeconds / juce::jmax (seconds, 1.0e-6), 1) + "x realtime)";
+        }
+
+        // Renders one segment of a --split file into memory and hands it to stitch()
+        void renderSegment (const Segment& segment)
+        {
+            auto& file = *segment.file;
+            auto start = static_cast<juce::int64> (segment.index) * file.segmentLength;
+            auto end = juce::jmin (file.length, start + file.segmentLength);
+
+            juce::AudioBuffer<float> rendered (file.numChannels, static_cast<int> (end - start));
+            std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (file.input));
+            juce::String error;
+
+            if (reader == nullptr)
+                error = "could not open as audio";
+            else
+                error = prepareProcessor (processor, file.numChannels, file.sampleRate, settings.blockSize);
+
+            if (error.isEmpty())
+            {
+                auto preRoll = getPreRollSamples (processor, settings, file.sampleRate);
+                auto numRendered = 0;
+
+                auto completed = renderRange (processor, *reader, settings.blockSize, start, end, preRoll,
+                                              [&] (const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+                                              {
+                                                  for (int channel = 0; channel < file.numChannels; ++channel)
+                                                      rendered.copyFrom (channel, numRendered, buffer, channel, startSample, numSamples);
+
+                                                  numRendered += numSamples;
+                                              });
+
+                if (! completed)
+                    error = "cancelled";
+
+                processor.releaseResources();
+
+                const juce::ScopedLock sl (file.lock);
+                file.preRollSeconds = static_cast<double> (preRoll) / file.sampleRate;
+            }
+
+            stitch (file, segment.index, std::move (rendered), error);
+        }
+
+        static void stitch (SplitFile& file, int index, juce::AudioBuffer<float> rendered, const juce::String& error)
+        {
+            const juce::ScopedLock sl (file.lock);
+
+            if (file.error.isEmpty())
+                file.error = error;
+
+            file.pending.emplace (index, std::move (rendered));
+
+            // Write out every segment that is now next in line (nothing more once one failed)
+            for (auto next = file.pending.find (file.numStitched); next != file.pending.end();
+                 next = file.pending.find (file.numStitched))
+            {
+                if (file.error.isEmpty()
+                     && ! file.writer->writeFromAudioSampleBuffer (next->second, 0, next->second.getNumSamples()))
+                    file.error = "could not write " + file.output.getFullPathName();
+
+                if (file.error.isEmpty() && file.stitched.getNumSamples() > 0)
+                    for (int channel = 0; channel < file.numChannels; ++channel)
+                        file.stitched.copyFrom (channel, static_cast<int> (next->first * file.segmentLength),
+                                                next->second, channel, 0, next->second.getNumSamples());
+
+                file.pending.erase (next);
+                ++file.numStitched;
+            }
+        }
+
+        juce::String fail (const juce::File& input, const juce::String& reason)
+        {
+            ++numFailed;
+            return "FAILED " + input.getFullPathName() + ": " + reason;
+        }
+
+        //==============================================================================
+        const RenderSettings& settings;
+        const std::vector<Segment>& segments;
+        std::atomic<int>& nextFile;
+        juce::StringArray& results;
+        juce::CriticalSection& resultsLock;
+
+        ClaudeAmpProcessor processor;
+        juce::AudioFormatManager formatManager;
+        int numFailed = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderWorker)
+    };
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    RenderSettings settings;
+
+    if (! parseArguments (argc, argv, settings))
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (settings.outputDirectory != juce::File() && ! settings.outputDirectory.createDirectory())
+    {
+        std::cerr << "Could not create " << settings.outputDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    // --split: every file's segments go in one list, in file order. The main
+    // thread opens the outputs so the workers only have to append to them
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::vector<std::unique_ptr<SplitFile>> splitFiles;
+    std::vector<Segment> segments;
+    juce::StringArray results;
+    auto numSplitFailed = 0;
+
+    if (settings.split)
+    {
+        for (auto& input : settings.inputFiles)
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (input));
+            auto output = reader != nullptr ? createOutput (formatManager, settings, input, *reader) : RenderOutput();
+
+            if (output.writer == nullptr)
+            {
+                results.add ("FAILED " + input.getFullPathName() + ": "
+                             + (reader == nullptr ? juce::String ("could not open as audio") : output.error));
+                ++numSplitFailed;
+                continue;
+            }
+
+            auto file = std::make_unique<SplitFile>();
+            file->input = input;
+            file->output = output.file;
+            file->writer = std::move (output.writer);
+            file->numChannels = static_cast<int> (reader->numChannels);
+            file->sampleRate = reader->sampleRate;
+            file->length = reader->lengthInSamples;
+            file->segmentLength = juce::jmax (static_cast<juce::int64> (1),
+                                              static_cast<juce::int64> (settings.segmentSeconds * reader->sampleRate));
+            file->numSegments = static_cast<int> ((file->length + file->segmentLength - 1) / file->segmentLength);
+
+            // --verify compares in memory, so it is limited to files a buffer can hold
+            if (settings.verify && file->length <= std::numeric_limits<int>::max())
+                file->stitched.setSize (file->numChannels, static_cast<int> (file->length));
+
+            for (int i = 0; i < file->numSegments; ++i)
+                segments.push_back ({ file.get(), i });
+
+            splitFiles.push_back (std::move (file));
+        }
+    }
+
+    std::atomic<int> nextFile { 0 };
+    juce::CriticalSection resultsLock;
+
+    // Processors are created here on the message thread, then handed to the workers
+    auto numWorkers = juce::jmin (settings.numJobs, settings.split ? static_cast<int> (segments.size())
+                                                                   : settings.inputFiles.size());
+    std::vector<std::unique_ptr<RenderWorker>> workers;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back (std::make_unique<RenderWorker> (settings, segments, nextFile, results, resultsLock));
+
+        if (! workers.back()->configure())
+            return 1;
+    }
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    auto numFailed = numSplitFailed;
+
+    for (auto& worker : workers)
+    {
+        worker->waitForThreadToExit (-1);
+        numFailed += worker->getNumFailed();
+    }
+
+    auto seconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    auto audioSeconds = 0.0;
+
+    // Close the stitched files, then compare their float output with serial renders if asked to
+    std::unique_ptr<ClaudeAmpProcessor> serialProcessor;
+
+    for (auto& file : splitFiles)
+    {
+        file->writer.reset();
+        audioSeconds += static_cast<double> (file->length) / file->sampleRate;
+
+        if (file->error.isNotEmpty())
+        {
+            file->output.deleteFile();
+            results.add ("FAILED " + file->input.getFullPathName() + ": " + file->error);
+            ++numFailed;
+            continue;
+        }
+
+        auto line = file->input.getFileName() + " -> " + file->output.getFullPathName()
+                  + " (" + juce::String (file->numSegments) + " segments, "
+                  + juce::String (file->preRollSeconds, 2) + " s pre-roll)";
+
+        if (settings.verify)
+        {
+            if (serialProcessor == nullptr)
+            {
+                serialProcessor = std::make_unique<ClaudeAmpProcessor>();
+                serialProcessor->setNonRealtime (true);
+                applySettings (*serialProcessor, settings);
+            }
+
+            auto deviation = measureDeviation (*serialProcessor, formatManager, *file, settings.blockSize);
+
+            if (deviation < 0.0f)
+                line << ", not verified";
+            else if (deviation == 0.0f)
+                line << ", identical to a serial render";
+            else
+                line << ", max deviation from a serial render " << juce::String (juce::Decibels::gainToDecibels (deviation), 1) << " dBFS";
+        }
+
+        results.add (line);
+    }
+
+    for (auto& line : results)
+        std::cout << line << "\n";
+
+    std::cout << "Rendered " << settings.inputFiles.size() - numFailed << " of " << settings.inputFiles.size()
+              << " files with " << numWorkers << " workers in " << juce::String (seconds, 2) << " s";
+
+    if (settings.split)
+        std::cout << " (" << juce::String (audioSeconds / juce::jmax (seconds, 1.0e-6), 1) << "x realtime)";
+
+    std::cout << "\n";
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,747 @@
+#include "AmpBank.h"
+#include "PluginProcessor.h"
+#include "ToolHelpers.h"
+
+#include <iostream>
+#include <numeric>
+
+#if JUCE_MAC
+ #include <malloc/malloc.h>
+#elif defined (__GLIBC__)
+ #include <malloc.h>
+#endif
+
+//==============================================================================
+/*
+    ClaudeAmpBenchmark
+
+    Times ClaudeAmpProcessor::processBlock across a matrix of sample rates,
+    block sizes, channel layouts (mono, stereo, mono in/stereo out and stereo
+    with identical channels), cabinet off/lite/full, channel mode and static
+    versus automated parameters. Every configuration reports ns/sample,
+    realtime factor and p50/p99/max per-block time. Results are written as
+    JSON so runs from different releases can be diffed.
+
+    A second set of results times the preamp (chain stages 2-9) on 4x
+    oversampled blocks, run stage by stage and as the fused kernel, for the
+    mono and the vector chain. Each reports ns/sample, the bytes of block
+    memory each sample costs (a read and a write per pass) and the largest
+    output difference between the two, which should be zero.
+
+    It also renders a take with a silence gap longer than the silence skip's
+    wait at every block size, and reports each render's largest difference
+    from one made in small odd-sized blocks.
+
+    The bank comparison runs N mono-in processors and one AmpBank of N
+    instances side by side, with different settings per instance and a
+    settings change halfway. It reports the time per instance-sample of each,
+    the heap each needs once prepared (where the platform reports heap use)
+    and the largest output difference between them, which should be zero.
+
+    Finally it saves and restores a session's state many times, in the binary
+    format and in the XML that earlier versions wrote, and reports the size and
+    the time per save and per load of each, and whether each restores the
+    session exactly.
+
+    Usage:
+        ClaudeAmpBenchmark [options]
+
+    Options:
+        --output <file>             Write JSON here (default: stdout)
+        --seconds <s>               Audio rendered per configuration (default: 1.0)
+        --sample-rates <a,b,...>    Override the sample rate list
+        --block-sizes <a,b,...>     Override the block size list
+        --quick                     48k/96k and 64/512/4096 only
+*/
+
+namespace
+{
+    using ToolHelpers::setParameter;
+    using ToolHelpers::fillTestSignal;
+
+    struct BenchmarkSettings
+    {
+        juce::File outputFile;
+        double secondsPerConfig = 1.0;
+        juce::Array<double> sampleRates { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+        juce::Array<int> blockSizes { 16, 64, 256, 1024, 4096, 8192 };
+    };
+
+    struct Layout
+    {
+        const char* name;
+        int numInputs, numOutputs;
+        bool identicalInputs;  // Same signal on every input channel
+    };
+
+    const Layout layouts[] = { { "mono",        1, 1, true },
+                               { "stereo",      2, 2, false },
+                               { "mono-stereo", 1, 2, true },
+                               { "dual-mono",   2, 2, true } };
+
+    struct Configuration
+    {
+        double sampleRate;
+        int blockSize;
+        Layout layout;
+        int cabinet;     // 0 = Off, 1 = Lite, 2 = Full
+        int mode;        // 0 = Normal, 1 = Bright, 2 = Link
+        bool automated;
+    };
+
+    const char* const cabinetNames[] = { "off", "lite", "full" };
+    const char* const modeNames[] = { "Normal", "Bright", "Link" };
+
+    bool parseArguments (int argc, char* argv[], BenchmarkSettings& settings)
+    {
+        auto parseList = [] (const juce::String& text)
+        {
+            juce::StringArray tokens;
+            tokens.addTokens (text, ",", {});
+            tokens.removeEmptyStrings();
+            return tokens;
+        };
+
+        for (int i = 1; i < argc; ++i)
+        {
+            juce::String arg (argv[i]);
+            auto hasValue = i + 1 < argc;
+
+            if (arg == "--output" && hasValue)
+                settings.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+            else if (arg == "--seconds" && hasValue)
+                settings.secondsPerConfig = juce::jmax (0.01, juce::String (argv[++i]).getDoubleValue());
+            else if (arg == "--sample-rates" && hasValue)
+            {
+                settings.sampleRates.clear();
+
+                for (auto& token : parseList (argv[++i]))
+                    settings.sampleRates.add (token.getDoubleValue());
+            }
+            else if (arg == "--block-sizes" && hasValue)
+            {
+                settings.blockSizes.clear();
+
+                for (auto& token : parseList (argv[++i]))
+                    settings.blockSizes.add (token.getIntValue());
+            }
+            else if (arg == "--quick")
+            {
+                settings.sampleRates = { 48000.0, 96000.0 };
+                settings.blockSizes = { 64, 512, 4096 };
+            }
+            else
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << "\n";
+                return false;
+            }
+        }
+
+        return ! settings.sampleRates.isEmpty() && ! settings.blockSizes.isEmpty();
+    }
+
+    //==============================================================================
+    juce::var runConfiguration (const Configuration& config, double secondsPerConfig)
+    {
+        ClaudeAmpProcessor processor;
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (juce::AudioChannelSet::canonicalChannelSet (config.layout.numInputs));
+        layout.outputBuses.add (juce::AudioChannelSet::canonicalChannelSet (config.layout.numOutputs));
+        processor.setBusesLayout (layout);
+
+        auto numInputs = config.layout.numInputs;
+        auto numBufferChannels = juce::jmax (numInputs, config.layout.numOutputs);
+
+        setParameter (processor, "cabinet", static_cast<float> (config.cabinet));
+        setParameter (processor, "channel", config.mode == 1 ? 1.0f : 0.0f);
+        setParameter (processor, "link", config.mode == 2 ? 1.0f : 0.0f);
+
+        processor.setRateAndBufferSizeDetails (config.sampleRate, config.blockSize);
+        processor.prepareToPlay (config.sampleRate, config.blockSize);
+        auto coldPrepare = processor.getLastPrepareStats();
+
+        // Hosts re-prepare with unchanged settings on every transport restart
+        processor.prepareToPlay (config.sampleRate, config.blockSize);
+        auto warmPrepare = processor.getLastPrepareStats();
+        jassert (warmPrepare.warm);
+
+        // At least 32 measured blocks so p99/max mean something for large blocks
+        auto numBlocks = juce::jmax (32, static_cast<int> (secondsPerConfig * config.sampleRate) / config.blockSize);
+        auto numWarmUpBlocks = juce::jmax (4, numBlocks / 10);
+
+        juce::AudioBuffer<float> source (numInputs, (numBlocks + numWarmUpBlocks) * config.blockSize);
+        fillTestSignal (source, config.sampleRate, config.layout.identicalInputs);
+
+        juce::AudioBuffer<float> buffer (numBufferChannels, config.blockSize);
+        juce::MidiBuffer midi;
+        std::vector<double> blockNanoseconds;
+        blockNanoseconds.reserve (static_cast<size_t> (numBlocks));
+
+        const char* const automatedIds[] = { "drive", "bass", "mid", "treble", "presence", "master" };
+
+        for (int block = 0; block < numWarmUpBlocks + numBlocks; ++block)
+        {
+            for (int channel = 0; channel < numInputs; ++channel)
+                buffer.copyFrom (channel, 0, source, channel, block * config.blockSize, config.blockSize);
+
+            // Automation: every knob moves every block, like dense host automation lanes
+            if (config.automated)
+            {
+                auto phase = static_cast<float> (block * config.blockSize) / static_cast<float> (config.sampleRate);
+
+                for (int i = 0; i < 6; ++i)
+                    setParameter (processor, automatedIds[i],
+                                  5.0f + 4.5f * std::sin (juce::MathConstants<float>::twoPi * (0.5f + 0.3f * i) * phase));
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            processor.processBlock (buffer, midi);
+            auto end = std::chrono::steady_clock::now();
+
+            if (block >= numWarmUpBlocks)
+                blockNanoseconds.push_back (std::chrono::duration<double, std::nano> (end - start).count());
+        }
+
+        processor.releaseResources();
+
+        auto totalNanoseconds = std::accumulate (blockNanoseconds.begin(), blockNanoseconds.end(), 0.0);
+        auto numSamples = static_cast<double> (numBlocks) * config.blockSize;
+        auto audioNanoseconds = numSamples / config.sampleRate * 1.0e9;
+
+        std::sort (blockNanoseconds.begin(), blockNanoseconds.end());
+
+        auto percentile = [&blockNanoseconds] (double p)
+        {
+            auto index = static_cast<size_t> (p * static_cast<double> (blockNanoseconds.size() - 1) + 0.5);
+            return blockNanoseconds[index];
+        };
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("sampleRate", config.sampleRate);
+        result->setProperty ("blockSize", config.blockSize);
+        result->setProperty ("layout", config.layout.name);
+        result->setProperty ("cabinet", cabinetNames[config.cabinet]);
+        result->setProperty ("mode", modeNames[config.mode]);
+        result->setProperty ("automated", config.automated);
+        result->setProperty ("blocks", numBlocks);
+        result->setProperty ("nsPerSample", totalNanoseconds / numSamples);
+        result->setProperty ("realtimeFactor", audioNanoseconds / totalNanoseconds);
+        result->setProperty ("blockNsP50", percentile (0.50));
+        result->setProperty ("blockNsP99", percentile (0.99));
+        result->setProperty ("blockNsMax", blockNanoseconds.back());
+        result->setProperty ("latencySamples", processor.getLatencySamples());
+        result->setProperty ("prepareMs", coldPrepare.milliseconds);
+        result->setProperty ("warmPrepareMs", warmPrepare.milliseconds);
+
+        return juce::var (result);
+    }
+
+    //==============================================================================
+    template <typename Chain, typename SampleType, size_t... Indices>
+    void processPreampStages (Chain& chain, const juce::dsp::ProcessContextReplacing<SampleType>& context,
+                              std::index_sequence<Indices...>) noexcept
+    {
+        (chain.template get<static_cast<int> (Indices) + 2>().process (context), ...);
+    }
+
+    template <typename SampleType>
+    juce::var runPreampKernel (int blockSize, double secondsPerConfig)
+    {
+        constexpr auto numLanes = sizeof (SampleType) / sizeof (float);
+        constexpr int numStages = 8;    // Stages 2-9
+        const auto sampleRate = 48000.0;
+        const auto oversampledRate = 4.0 * sampleRate;
+        auto numSamples = static_cast<size_t> (4 * blockSize);
+
+        auto preEmphasis = PlexiVoicing::makePreEmphasis (oversampledRate);
+        auto deEmphasis = PlexiVoicing::makeDeEmphasis (oversampledRate);
+
+        ToneStackModel toneStackModel;
+        float toneStack[ToneStackModel::coefficientsPerToneStack];
+        toneStackModel.prepare (oversampledRate);
+        toneStackModel.getToneStack (7.0f, 4.0f, 6.5f, toneStack);
+
+        PlexiChain<SampleType> staged, fused;
+
+        for (auto* chain : { &staged, &fused })
+        {
+            chain->template get<2>().coefficients = preEmphasis;
+            chain->template get<8>().coefficients = deEmphasis;
+            chain->template get<9>().coefficients = toneStack;
+
+            PlexiVoicing::initialiseTubeStages (*chain);
+            chain->prepare ({ oversampledRate, static_cast<juce::uint32> (numSamples), 1 });
+            PlexiVoicing::configureFixedStages (*chain);
+        }
+
+        // The test signal at the level the drive stage would feed the preamp
+        juce::AudioBuffer<float> signal (1, static_cast<int> (numSamples));
+        fillTestSignal (signal, oversampledRate, true);
+        signal.applyGain (8.0f);
+
+        juce::HeapBlock<char> sourceData, stagedData, fusedData;
+        juce::dsp::AudioBlock<SampleType> source (sourceData, 1, numSamples);
+        juce::dsp::AudioBlock<SampleType> stagedBlock (stagedData, 1, numSamples);
+        juce::dsp::AudioBlock<SampleType> fusedBlock (fusedData, 1, numSamples);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            for (size_t lane = 0; lane < numLanes; ++lane)
+                PlexiStages::setLane (source.getChannelPointer (0)[i], lane, signal.getSample (0, static_cast<int> (i)));
+
+        auto numBlocks = juce::jmax (32, static_cast<int> (secondsPerConfig * oversampledRate) / static_cast<int> (numSamples));
+        double stagedNanoseconds = 0.0, fusedNanoseconds = 0.0;
+        float maxDifference = 0.0f;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            stagedBlock.copyFrom (source);
+            fusedBlock.copyFrom (source);
+
+            auto start = std::chrono::steady_clock::now();
+            processPreampStages (staged, juce::dsp::ProcessContextReplacing<SampleType> (stagedBlock),
+                                 std::make_index_sequence<numStages>());
+            auto middle = std::chrono::steady_clock::now();
+            PlexiVoicing::processPreamp (fused, fusedBlock);
+            auto end = std::chrono::steady_clock::now();
+
+            stagedNanoseconds += std::chrono::duration<double, std::nano> (middle - start).count();
+            fusedNanoseconds += std::chrono::duration<double, std::nano> (end - middle).count();
+
+            for (size_t i = 0; i < numSamples; ++i)
+                for (size_t lane = 0; lane < numLanes; ++lane)
+                    maxDifference = juce::jmax (maxDifference, std::abs (PlexiStages::getLane (stagedBlock.getChannelPointer (0)[i], lane)
+                                                                         - PlexiStages::getLane (fusedBlock.getChannelPointer (0)[i], lane)));
+        }
+
+        auto totalSamples = static_cast<double> (numBlocks) * static_cast<double> (numSamples);
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("chain", numLanes == 1 ? "mono" : "vector");
+        result->setProperty ("blockSize", blockSize);
+        result->setProperty ("oversampledBlockBytes", static_cast<int> (numSamples * sizeof (SampleType)));
+        result->setProperty ("stagedNsPerSample", stagedNanoseconds / totalSamples);
+        result->setProperty ("fusedNsPerSample", fusedNanoseconds / totalSamples);
+        result->setProperty ("stagedBytesPerSample", static_cast<int> (2 * numStages * sizeof (SampleType)));
+        result->setProperty ("fusedBytesPerSample", static_cast<int> (2 * sizeof (SampleType)));
+        result->setProperty ("maxDifference", maxDifference);
+
+        return juce::var (result);
+    }
+
+    //==============================================================================
+    juce::var runBlockSizeIndependence (const juce::Array<int>& blockSizes, int cabinet)
+    {
+        // Playing, then a gap the silence skip engages in, then playing again
+        const auto sampleRate = 48000.0;
+        const int referenceBlockSize = 37;
+        auto numPlayingSamples = static_cast<int> (sampleRate);
+        auto numGapSamples = static_cast<int> (6.0 * sampleRate);
+        auto numSamples = 2 * numPlayingSamples + numGapSamples;
+
+        juce::AudioBuffer<float> source (1, numSamples);
+        source.clear();
+
+        juce::AudioBuffer<float> playing (1, numPlayingSamples);
+        fillTestSignal (playing, sampleRate, true);
+        source.copyFrom (0, 0, playing, 0, 0, numPlayingSamples);
+        source.copyFrom (0, numPlayingSamples + numGapSamples, playing, 0, 0, numPlayingSamples);
+
+        auto render = [&] (int blockSize)
+        {
+            ClaudeAmpProcessor processor;
+            setParameter (processor, "cabinet", static_cast<float> (cabinet));
+            setParameter (processor, "drive", 8.0f);
+            processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+            processor.prepareToPlay (sampleRate, blockSize);
+
+            juce::AudioBuffer<float> output (source);
+            juce::AudioBuffer<float> buffer (1, blockSize);
+            juce::MidiBuffer midi;
+
+            for (int start = 0; start < numSamples; start += blockSize)
+            {
+                auto count = juce::jmin (blockSize, numSamples - start);
+                juce::AudioBuffer<float> block (output.getArrayOfWritePointers(), 1, start, count);
+                processor.processBlock (block, midi);
+            }
+
+            processor.releaseResources();
+            return output;
+        };
+
+        auto reference = render (referenceBlockSize);
+        juce::Array<juce::var> renders;
+
+        for (auto blockSize : blockSizes)
+        {
+            auto output = render (blockSize);
+            auto maxDifference = 0.0f;
+
+            for (int i = 0; i < numSamples; ++i)
+                maxDifference = juce::jmax (maxDifference, std::abs (output.getSample (0, i) - reference.getSample (0, i)));
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty ("blockSize", blockSize);
+            result->setProperty ("maxDifference", maxDifference);
+            renders.add (juce::var (result));
+        }
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("cabinet", cabinetNames[cabinet]);
+        result->setProperty ("referenceBlockSize", referenceBlockSize);
+        result->setProperty ("gapSeconds", numGapSamples / sampleRate);
+        result->setProperty ("renders", renders);
+
+        return juce::var (result);
+    }
+
+    //==============================================================================
+    // Heap bytes malloc reports in use (glibc: the main thread's arena), or -1
+    // where the platform can't tell
+    juce::int64 getHeapBytesInUse()
+    {
+       #if JUCE_MAC
+        malloc_statistics_t stats;
+        malloc_zone_statistics (nullptr, &stats);
+        return static_cast<juce::int64> (stats.size_in_use);
+       #elif defined (__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        return static_cast<juce::int64> (mallinfo2().uordblks);
+       #else
+        return -1;
+       #endif
+    }
+
+    // Settings that differ between instances, within each parameter's range
+    void setInstanceParameters (ClaudeAmpProcessor& processor, int instance, bool changed)
+    {
+        setParameter (processor, "channel", static_cast<float> (instance % 2));
+        setParameter (processor, "link", instance % 3 == 2 ? 1.0f : 0.0f);
+        setParameter (processor, "drive", changed ? 9.0f - 0.3f * static_cast<float> (instance % 10)
+                                                  : 2.0f + 0.7f * static_cast<float> (instance % 10));
+        setParameter (processor, "bass", 3.0f + 0.5f * static_cast<float> (instance % 9));
+        setParameter (processor, "mid", 8.0f - 0.5f * static_cast<float> (instance % 11));
+        setParameter (processor, "treble", changed ? 2.5f : 4.0f + 0.4f * static_cast<float> (instance % 12));
+        setParameter (processor, "presence", 1.0f + 0.8f * static_cast<float> (instance % 10));
+        setParameter (processor, "master", 6.0f - 0.2f * static_cast<float> (instance % 7));
+        setParameter (processor, "cabinet", static_cast<float> (1 + instance % 2));
+    }
+
+    // The bank settings a processor runs with, read back so both see the same
+    // snapped parameter values
+    AmpBank::Settings getBankSettings (ClaudeAmpProcessor& processor)
+    {
+        auto value = [&processor] (const char* id) { return processor.apvts.getRawParameterValue (id)->load(); };
+
+        AmpBank::Settings settings;
+        settings.channel = static_cast<int> (value ("channel"));
+        settings.link = value ("link") > 0.5f;
+        settings.drive = value ("drive");
+        settings.bass = value ("bass");
+        settings.mid = value ("mid");
+        settings.treble = value ("treble");
+        settings.presence = value ("presence");
+        settings.master = value ("master");
+        settings.cabinet = static_cast<int> (value ("cabinet"));
+        return settings;
+    }
+
+    juce::var runBankComparison (int numInstances, int blockSize, double secondsPerConfig)
+    {
+        const auto sampleRate = 48000.0;
+        auto numBlocks = juce::jmax (32, static_cast<int> (secondsPerConfig * sampleRate) / blockSize);
+        auto numSamples = numBlocks * blockSize;
+
+        juce::AudioBuffer<float> source (1, numSamples);
+        fillTestSignal (source, sampleRate, true);
+
+        // Footprint: what constructing and preparing each side leaves on the heap
+        auto heapBefore = getHeapBytesInUse();
+        std::vector<std::unique_ptr<ClaudeAmpProcessor>> processors;
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            processors.push_back (std::make_unique<ClaudeAmpProcessor>());
+            auto& processor = *processors.back();
+
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add (juce::AudioChannelSet::mono());
+            layout.outputBuses.add (juce::AudioChannelSet::mono());
+            processor.setBusesLayout (layout);
+
+            setInstanceParameters (processor, i, false);
+            processor.setRateAndBufferSizeDetails (sampleRate, blockSize);
+            processor.prepareToPlay (sampleRate, blockSize);
+        }
+
+        auto heapProcessors = getHeapBytesInUse();
+        auto bank = std::make_unique<AmpBank> (numInstances);
+
+        for (int i = 0; i < numInstances; ++i)
+            bank->setSettings (i, getBankSettings (*processors[static_cast<size_t> (i)]));
+
+        bank->prepare (sampleRate, blockSize);
+        auto heapBank = getHeapBytesInUse();
+
+        juce::AudioBuffer<float> processorOutput (numInstances, blockSize), bankOutput (numInstances, blockSize);
+        juce::MidiBuffer midi;
+        double processorNanoseconds = 0.0, bankNanoseconds = 0.0;
+        auto maxDifference = 0.0f;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            // Halfway, every instance's drive and treble move, so both sides smooth them
+            if (block == numBlocks / 2)
+            {
+                for (int i = 0; i < numInstances; ++i)
+                {
+                    auto& processor = *processors[static_cast<size_t> (i)];
+                    setInstanceParameters (processor, i, true);
+                    bank->setSettings (i, getBankSettings (processor));
+                }
+            }
+
+            for (int i = 0; i < numInstances; ++i)
+            {
+                processorOutput.copyFrom (i, 0, source, 0, block * blockSize, blockSize);
+                bankOutput.copyFrom (i, 0, source, 0, block * blockSize, blockSize);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+
+            for (int i = 0; i < numInstances; ++i)
+            {
+                juce::AudioBuffer<float> channel (processorOutput.getArrayOfWritePointers() + i, 1, blockSize);
+                processors[static_cast<size_t> (i)]->processBlock (channel, midi);
+            }
+
+            auto middle = std::chrono::steady_clock::now();
+            bank->process (bankOutput.getArrayOfWritePointers(), blockSize);
+            auto end = std::chrono::steady_clock::now();
+
+            processorNanoseconds += std::chrono::duration<double, std::nano> (middle - start).count();
+            bankNanoseconds += std::chrono::duration<double, std::nano> (end - middle).count();
+
+            for (int i = 0; i < numInstances; ++i)
+                for (int sample = 0; sample < blockSize; ++sample)
+                    maxDifference = juce::jmax (maxDifference, std::abs (processorOutput.getSample (i, sample)
+                                                                         - bankOutput.getSample (i, sample)));
+        }
+
+        auto instanceSamples = static_cast<double> (numSamples) * numInstances;
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("instances", numInstances);
+        result->setProperty ("sampleRate", sampleRate);
+        result->setProperty ("blockSize", blockSize);
+        result->setProperty ("processorNsPerSample", processorNanoseconds / instanceSamples);
+        result->setProperty ("bankNsPerSample", bankNanoseconds / instanceSamples);
+
+        if (heapBefore >= 0)
+        {
+            result->setProperty ("processorHeapBytes", heapProcessors - heapBefore);
+            result->setProperty ("bankHeapBytes", heapBank - heapProcessors);
+        }
+
+        result->setProperty ("maxDifference", maxDifference);
+
+        return juce::var (result);
+    }
+
+    //==============================================================================
+    // getStateInformation() as it was before the binary format
+    void writeXmlState (ClaudeAmpProcessor& processor, juce::MemoryBlock& destData)
+    {
+        auto state = processor.apvts.copyState();
+        state.setProperty ("stateVersion", 1, nullptr);
+        std::unique_ptr<juce::XmlElement> xml (state.createXml());
+        juce::AudioProcessor::copyXmlToBinary (*xml, destData);
+    }
+
+    juce::var runStateFormats (double secondsPerConfig)
+    {
+        // A session with every kind of setting away from its default
+        ClaudeAmpProcessor processor;
+        setParameter (processor, "channel", 1.0f);
+        setParameter (processor, "drive", 7.5f);
+        setParameter (processor, "bass", 6.2f);
+        setParameter (processor, "treble", 3.9f);
+        setParameter (processor, "cabinet", 1.0f);
+        setParameter (processor, "oversampling", 6.0f);
+
+        auto options = processor.getCabinetOptions();
+        options.minimumPhase = true;
+        options.maximumLengthSeconds = 0.2;
+        processor.setCabinetOptions (options);
+
+        juce::MemoryBlock binary, xml;
+        processor.getStateInformation (binary);
+        writeXmlState (processor, xml);
+
+        // Both formats must restore the same session
+        auto restoresSession = [&binary] (const juce::MemoryBlock& state)
+        {
+            ClaudeAmpProcessor restored;
+            restored.setStateInformation (state.getData(), static_cast<int> (state.getSize()));
+
+            juce::MemoryBlock saved;
+            restored.getStateInformation (saved);
+            return saved == binary;
+        };
+
+        auto iterations = juce::jmax (1000, static_cast<int> (secondsPerConfig * 20000.0));
+
+        auto time = [iterations] (auto&& operation)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            for (int i = 0; i < iterations; ++i)
+                operation();
+
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::micro> (end - start).count() / iterations;
+        };
+
+        juce::MemoryBlock destination;
+        ClaudeAmpProcessor target;
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty ("iterations", iterations);
+        result->setProperty ("binaryBytes", static_cast<int> (binary.getSize()));
+        result->setProperty ("xmlBytes", static_cast<int> (xml.getSize()));
+        result->setProperty ("binarySaveUs", time ([&] { processor.getStateInformation (destination); }));
+        result->setProperty ("xmlSaveUs", time ([&] { writeXmlState (processor, destination); }));
+        result->setProperty ("binaryLoadUs", time ([&] { target.setStateInformation (binary.getData(), static_cast<int> (binary.getSize())); }));
+        result->setProperty ("xmlLoadUs", time ([&] { target.setStateInformation (xml.getData(), static_cast<int> (xml.getSize())); }));
+        result->setProperty ("binaryRestoresSession", restoresSession (binary));
+        result->setProperty ("xmlRestoresSession", restoresSession (xml));
+
+        return juce::var (result);
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    BenchmarkSettings settings;
+
+    if (! parseArguments (argc, argv, settings))
+        return 1;
+
+    juce::Array<juce::var> results;
+
+    for (auto sampleRate : settings.sampleRates)
+    {
+        for (auto blockSize : settings.blockSizes)
+        {
+            for (auto& layout : layouts)
+            {
+                for (auto cabinet : { 0, 1, 2 })
+                {
+                    for (auto mode : { 0, 1, 2 })
+                    {
+                        for (auto automated : { false, true })
+                        {
+                            Configuration config { sampleRate, blockSize, layout, cabinet, mode, automated };
+                            auto result = runConfiguration (config, settings.secondsPerConfig);
+
+                            std::cerr << juce::String (sampleRate / 1000.0, 1) << "k "
+                                      << blockSize << " " << layout.name << " "
+                                      << "cab:" << cabinetNames[cabinet] << " "
+                                      << modeNames[mode] << (automated ? " automated" : " static") << ": "
+                                      << juce::String (static_cast<double> (result["nsPerSample"]), 1) << " ns/sample, "
+                                      << juce::String (static_cast<double> (result["realtimeFactor"]), 1) << "x realtime\n";
+
+                            results.add (result);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    juce::Array<juce::var> preampResults;
+
+    for (auto blockSize : settings.blockSizes)
+    {
+        for (auto result : { runPreampKernel<float> (blockSize, settings.secondsPerConfig),
+                             runPreampKernel<juce::dsp::SIMDRegister<float>> (blockSize, settings.secondsPerConfig) })
+        {
+            std::cerr << "preamp " << blockSize << " " << result["chain"].toString() << ": "
+                      << juce::String (static_cast<double> (result["stagedNsPerSample"]), 2) << " ns/sample staged, "
+                      << juce::String (static_cast<double> (result["fusedNsPerSample"]), 2) << " ns/sample fused, "
+                      << "max difference " << static_cast<double> (result["maxDifference"]) << "\n";
+
+            preampResults.add (result);
+        }
+    }
+
+    juce::Array<juce::var> blockSizeResults;
+
+    for (auto cabinet : { 0, 2 })
+    {
+        auto result = runBlockSizeIndependence (settings.blockSizes, cabinet);
+
+        for (auto& render : *result["renders"].getArray())
+            std::cerr << "silence gap cab:" << result["cabinet"].toString() << " " << static_cast<int> (render["blockSize"])
+                      << ": max difference " << static_cast<double> (render["maxDifference"]) << "\n";
+
+        blockSizeResults.add (result);
+    }
+
+    juce::Array<juce::var> bankResults;
+
+    for (auto numInstances : { 1, 8, 32 })
+    {
+        auto result = runBankComparison (numInstances, 512, settings.secondsPerConfig);
+
+        std::cerr << "bank " << numInstances << " instances: "
+                  << juce::String (static_cast<double> (result["processorNsPerSample"]), 2) << " ns/sample as processors, "
+                  << juce::String (static_cast<double> (result["bankNsPerSample"]), 2) << " ns/sample as a bank";
+
+        if (result.hasProperty ("bankHeapBytes"))
+            std::cerr << ", heap " << static_cast<juce::int64> (result["processorHeapBytes"]) << " against "
+                      << static_cast<juce::int64> (result["bankHeapBytes"]) << " bytes";
+
+        std::cerr << ", max difference " << static_cast<double> (result["maxDifference"]) << "\n";
+
+        bankResults.add (result);
+    }
+
+    auto stateResult = runStateFormats (settings.secondsPerConfig);
+
+    std::cerr << "state: binary " << static_cast<int> (stateResult["binaryBytes"]) << " bytes, save "
+              << juce::String (static_cast<double> (stateResult["binarySaveUs"]), 2) << " us, load "
+              << juce::String (static_cast<double> (stateResult["binaryLoadUs"]), 2) << " us; xml "
+              << static_cast<int> (stateResult["xmlBytes"]) << " bytes, save "
+              << juce::String (static_cast<double> (stateResult["xmlSaveUs"]), 2) << " us, load "
+              << juce::String (static_cast<double> (stateResult["xmlLoadUs"]), 2) << " us\n";
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty ("tool", "ClaudeAmpBenchmark");
+    report->setProperty ("version", CLAUDEAMP_VERSION);
+    report->setProperty ("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty ("numCpus", juce::SystemStats::getNumCpus());
+    report->setProperty ("os", juce::SystemStats::getOperatingSystemName());
+    report->setProperty ("time", juce::Time::getCurrentTime().toISO8601 (true));
+    report->setProperty ("secondsPerConfig", settings.secondsPerConfig);
+    report->setProperty ("results", results);
+    report->setProperty ("preampKernel", preampResults);
+    report->setProperty ("blockSizeIndependence", blockSizeResults);
+    report->setProperty ("bankComparison", bankResults);
+    report->setProperty ("stateFormats", stateResult);
+
+    auto json = juce::JSON::toString (juce::var (report));
+
+    if (settings.outputFile == juce::File())
+        std::cout << json << "\n";
+    else if (! settings.outputFile.replaceWithText (json))
+    {
+        std::cerr << "Could not write " << settings.outputFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
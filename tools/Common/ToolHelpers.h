@@ -0,0 +1,52 @@
+#pragma once
+
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    Helpers the command-line tools share: setting parameters in their own
+    units, and the synthesised guitar signal they measure with.
+*/
+namespace ToolHelpers
+{
+    /** Sets a parameter from a value in its own range (not normalised). */
+    inline void setParameter (ClaudeAmpProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* parameter = processor.apvts.getParameter (id))
+            parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    /** Deterministic guitar-ish test signal: decaying plucked partials plus a
+        little noise, with independent noise per channel unless the channels
+        should be identical.
+    */
+    inline void fillTestSignal (juce::AudioBuffer<float>& buffer, double sampleRate, bool identicalChannels)
+    {
+        juce::Random random (0x5eed);
+        const double fundamentals[] = { 82.41, 110.0, 146.83, 196.0 };
+
+        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        {
+            auto t = static_cast<double> (sample) / sampleRate;
+            auto note = fundamentals[static_cast<size_t> (t * 2.0) % 4];
+            auto noteTime = std::fmod (t, 0.5);
+            auto envelope = std::exp (-noteTime * 6.0);
+
+            auto value = 0.0;
+
+            for (int harmonic = 1; harmonic <= 6; ++harmonic)
+                value += std::sin (juce::MathConstants<double>::twoPi * note * harmonic * t) / harmonic;
+
+            auto sampleValue = static_cast<float> (0.25 * envelope * value);
+            auto noise = 0.001f * (random.nextFloat() - 0.5f);
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                if (channel > 0 && ! identicalChannels)
+                    noise = 0.001f * (random.nextFloat() - 0.5f);
+
+                buffer.setSample (channel, sample, sampleValue + noise);
+            }
+        }
+    }
+}
@@ -0,0 +1,568 @@
+#include "PluginProcessor.h"
+#include "ToolHelpers.h"
+
+#include <iostream>
+
+//==============================================================================
+/*
+    ClaudeAmpQualityExplorer
+
+    Measures what each quality setting gives up against what it costs, so CPU
+    settings can be picked per project from numbers. Every oversampling
+    choice (factor, IIR or linear-phase filters, ADAA) runs with the cabinet
+    off, lite and full, and each configuration reports side by side:
+
+      - THD and aliasing for a stepped sine sweep. Every tone sits exactly on
+        an FFT bin, and so do its harmonics, so anything found between them
+        is aliasing (harmonics folded back from above Nyquist). Both are in dB
+        relative to the fundamental.
+      - The null-test residual against a reference render of the same signals
+        (multitone, guitar DI) at the highest setting, 8x with linear-phase
+        filters, in dB relative to the reference. With the cabinet on, the
+        reference uses the full convolution, so Lite's model error counts.
+        Renders are aligned by their reported (integer) latency, which lines
+        up linear-phase and 1x configurations exactly. Minimum-phase (IIR)
+        filters delay each frequency differently, which no single delay
+        undoes, so their residual is mostly that phase response. For them the
+        magnitude-spectrum error (frame by frame, blind to phase) is the
+        comparable figure; both are reported, and "nullComparison" says
+        which one applies.
+      - CPU cost at each block size: ns/sample and realtime factor over the
+        null-test renders.
+
+    Guitar DI fixtures can be given as WAV/AIFF files at the chosen sample
+    rate; without any, a synthesised plucked-string signal stands in. Results
+    are written as JSON.
+
+    Usage:
+        ClaudeAmpQualityExplorer [options] [DI fixtures...]
+
+    Options:
+        --output <file>             Write JSON here (default: stdout)
+        --sample-rate <hz>          Sample rate (default: 48000)
+        --block-sizes <a,b,...>     Block sizes to time (default: 64,512,4096)
+        --seconds <s>               Length of the multitone and synthesised
+                                    guitar signals (default: 4)
+        --drive <0-10>              Drive for every render (default: 5)
+        --quick                     512-sample blocks and 1 s signals only
+*/
+
+namespace
+{
+    struct ExplorerSettings
+    {
+        juce::File outputFile;
+        double sampleRate = 48000.0;
+        juce::Array<int> blockSizes { 64, 512, 4096 };
+        double signalSeconds = 4.0;
+        float drive = 5.0f;
+        juce::Array<juce::File> fixtures;
+    };
+
+    struct Quality
+    {
+        const char* name;
+        int oversampling;  // "oversampling" choice: 1-4 = 1x-8x, 5 = 1x ADAA, 6 = 2x ADAA
+        int filter;        // "oversamplingFilter" choice: 0 = IIR, 1 = linear phase
+    };
+
+    // Filters only matter from 2x up
+    const Quality qualities[] = { { "1x",             1, 0 },
+                                  { "2x IIR",         2, 0 },
+                                  { "2x linear",      2, 1 },
+                                  { "4x IIR",         3, 0 },
+                                  { "4x linear",      3, 1 },
+                                  { "8x IIR",         4, 0 },
+                                  { "8x linear",      4, 1 },
+                                  { "1x ADAA",        5, 0 },
+                                  { "2x ADAA IIR",    6, 0 },
+                                  { "2x ADAA linear", 6, 1 } };
+
+    const Quality& referenceQuality = qualities[6];
+    constexpr int referenceBlockSize = 4096;
+
+    // IIR oversampling filters (from 2x up) shift phase with frequency
+    bool hasMinimumPhaseFilters (const Quality& quality) noexcept
+    {
+        return quality.filter == 0 && quality.oversampling != 1 && quality.oversampling != 5;
+    }
+
+    const char* const cabinetNames[] = { "off", "lite", "full" };
+
+    bool parseArguments (int argc, char* argv[], ExplorerSettings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            juce::String arg (argv[i]);
+            auto hasValue = i + 1 < argc;
+
+            if (arg == "--output" && hasValue)
+                settings.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile (argv[++i]);
+            else if (arg == "--sample-rate" && hasValue)
+                settings.sampleRate = juce::jmax (8000.0, juce::String (argv[++i]).getDoubleValue());
+            else if (arg == "--block-sizes" && hasValue)
+            {
+                juce::StringArray tokens;
+                tokens.addTokens (argv[++i], ",", {});
+                tokens.removeEmptyStrings();
+                settings.blockSizes.clear();
+
+                for (auto& token : tokens)
+                    settings.blockSizes.add (juce::jmax (16, token.getIntValue()));
+            }
+            else if (arg == "--seconds" && hasValue)
+                settings.signalSeconds = juce::jmax (0.1, juce::String (argv[++i]).getDoubleValue());
+            else if (arg == "--drive" && hasValue)
+                settings.drive = juce::jlimit (0.0f, 10.0f, juce::String (argv[++i]).getFloatValue());
+            else if (arg == "--quick")
+            {
+                settings.blockSizes = { 512 };
+                settings.signalSeconds = 1.0;
+            }
+            else if (arg.startsWith ("--"))
+            {
+                std::cerr << "Unknown or incomplete option: " << arg << "\n";
+                return false;
+            }
+            else
+                settings.fixtures.add (juce::File::getCurrentWorkingDirectory().getChildFile (arg));
+        }
+
+        return ! settings.blockSizes.isEmpty();
+    }
+
+    //==============================================================================
+    using ToolHelpers::setParameter;
+
+    struct Render
+    {
+        juce::AudioBuffer<float> output;
+        double nanoseconds = 0.0;  // Spent in processBlock
+        int latencySamples = 0;
+    };
+
+    // Runs a mono signal through a fresh processor. Latency is compensated, so
+    // output sample n lines up with input sample n
+    Render render (const juce::AudioBuffer<float>& input, const Quality& quality, int cabinet, int blockSize,
+                   const ExplorerSettings& settings)
+    {
+        ClaudeAmpProcessor processor;
+        processor.setNonRealtime (true);
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (juce::AudioChannelSet::mono());
+        layout.outputBuses.add (juce::AudioChannelSet::mono());
+        processor.setBusesLayout (layout);
+
+        setParameter (processor, "oversampling", static_cast<float> (quality.oversampling));
+        setParameter (processor, "oversamplingFilter", static_cast<float> (quality.filter));
+        setParameter (processor, "cabinet", static_cast<float> (cabinet));
+        setParameter (processor, "drive", settings.drive);
+
+        processor.setRateAndBufferSizeDetails (settings.sampleRate, blockSize);
+        processor.prepareToPlay (settings.sampleRate, blockSize);
+
+        Render result;
+        result.latencySamples = processor.getLatencySamples();
+
+        auto length = input.getNumSamples();
+        auto total = length + result.latencySamples;
+        result.output.setSize (1, length);
+
+        juce::AudioBuffer<float> buffer (1, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int position = 0; position < total; position += blockSize)
+        {
+            auto numSamples = juce::jmin (blockSize, total - position);
+            buffer.setSize (1, numSamples, false, false, true);
+            buffer.clear();
+
+            if (position < length)
+                buffer.copyFrom (0, 0, input, 0, position, juce::jmin (numSamples, length - position));
+
+            auto start = std::chrono::steady_clock::now();
+            processor.processBlock (buffer, midi);
+            auto end = std::chrono::steady_clock::now();
+
+            result.nanoseconds += std::chrono::duration<double, std::nano> (end - start).count();
+
+            // Skip output that is still inside the latency window
+            auto skip = juce::jlimit (0, numSamples, result.latencySamples - position);
+
+            if (skip < numSamples)
+                result.output.copyFrom (0, position + skip - result.latencySamples, buffer, 0, skip, numSamples - skip);
+        }
+
+        processor.releaseResources();
+        return result;
+    }
+
+    //==============================================================================
+    // Stepped sine sweep: each tone settles, then one FFT frame of it is analysed
+    constexpr int fftOrder = 15;
+    constexpr int fftSize = 1 << fftOrder;
+    constexpr int windowLobeBins = 3;   // Bins either side of an on-bin tone (periodic Blackman-Harris)
+    constexpr double toneSettleSeconds = 0.5;
+    constexpr double toneLevel = 0.25;
+    const double sweepFrequencies[] = { 110.0, 330.0, 1000.0, 2500.0, 5000.0, 8000.0 };
+
+    struct SteppedSweep
+    {
+        juce::AudioBuffer<float> audio;
+        juce::Array<int> bins;          // Each tone's FFT bin
+        juce::Array<int> frameOffsets;  // Where each tone's analysed frame starts
+    };
+
+    SteppedSweep makeSteppedSweep (double sampleRate)
+    {
+        SteppedSweep sweep;
+
+        for (auto frequency : sweepFrequencies)
+        {
+            // Odd bins: a folded harmonic can then only land on a true harmonic's
+            // bin for orders far beyond anything with measurable energy
+            if (frequency < 0.45 * sampleRate)
+                sweep.bins.add (juce::roundToInt (frequency * fftSize / sampleRate) | 1);
+        }
+
+        auto settleSamples = static_cast<int> (toneSettleSeconds * sampleRate);
+        auto toneLength = settleSamples + fftSize;
+        sweep.audio.setSize (1, sweep.bins.size() * toneLength);
+
+        for (int tone = 0; tone < sweep.bins.size(); ++tone)
+        {
+            auto* data = sweep.audio.getWritePointer (0, tone * toneLength);
+            auto bin = sweep.bins[tone];
+
+            for (int i = 0; i < toneLength; ++i)
+                data[i] = static_cast<float> (toneLevel * std::sin (juce::MathConstants<double>::twoPi * bin * i / fftSize));
+
+            sweep.frameOffsets.add (tone * toneLength + settleSamples);
+        }
+
+        return sweep;
+    }
+
+    struct ToneResult
+    {
+        double frequency;
+        double thdDecibels;       // Harmonics 2 and up, below Nyquist
+        double aliasingDecibels;  // Everything else above 20 Hz
+    };
+
+    ToneResult analyseTone (const float* frame, int bin, double sampleRate)
+    {
+        std::vector<float> data (2 * fftSize, 0.0f);
+
+        // Periodic 4-term Blackman-Harris: an on-bin tone spreads to windowLobeBins either side, no further
+        for (int i = 0; i < fftSize; ++i)
+        {
+            auto phase = juce::MathConstants<double>::twoPi * i / fftSize;
+            auto window = 0.35875 - 0.48829 * std::cos (phase) + 0.14128 * std::cos (2.0 * phase) - 0.01168 * std::cos (3.0 * phase);
+            data[static_cast<size_t> (i)] = frame[i] * static_cast<float> (window);
+        }
+
+        juce::dsp::FFT fft (fftOrder);
+        fft.performFrequencyOnlyForwardTransform (data.data(), true);
+
+        constexpr int nyquistBin = fftSize / 2;
+        std::vector<bool> harmonicBin (nyquistBin + 1, false);
+        auto fundamental = 0.0, harmonics = 0.0, rest = 0.0;
+
+        for (int harmonic = 1; harmonic * bin - windowLobeBins <= nyquistBin; ++harmonic)
+        {
+            auto power = 0.0;
+
+            for (int i = harmonic * bin - windowLobeBins; i <= juce::jmin (nyquistBin, harmonic * bin + windowLobeBins); ++i)
+            {
+                power += juce::square (static_cast<double> (data[static_cast<size_t> (i)]));
+                harmonicBin[static_cast<size_t> (i)] = true;
+            }
+
+            (harmonic == 1 ? fundamental : harmonics) += power;
+        }
+
+        // DC and subsonics (the DC blocker's corner) are left out
+        for (int i = static_cast<int> (std::ceil (20.0 * fftSize / sampleRate)); i <= nyquistBin; ++i)
+            if (! harmonicBin[static_cast<size_t> (i)])
+                rest += juce::square (static_cast<double> (data[static_cast<size_t> (i)]));
+
+        auto toDecibels = [fundamental] (double power) { return 10.0 * std::log10 (juce::jmax (power / fundamental, 1.0e-30)); };
+
+        return { bin * sampleRate / fftSize, toDecibels (harmonics), toDecibels (rest) };
+    }
+
+    //==============================================================================
+    struct TestSignal
+    {
+        juce::String name;
+        juce::AudioBuffer<float> audio;
+    };
+
+    // Seven tones with no simple ratios between them, 60 Hz to 6 kHz
+    TestSignal makeMultitone (double sampleRate, double seconds)
+    {
+        const double frequencies[] = { 61.0, 137.0, 283.0, 611.0, 1307.0, 2797.0, 5903.0 };
+
+        TestSignal signal { "multitone", juce::AudioBuffer<float> (1, static_cast<int> (seconds * sampleRate)) };
+
+        for (int sample = 0; sample < signal.audio.getNumSamples(); ++sample)
+        {
+            auto t = static_cast<double> (sample) / sampleRate;
+            auto value = 0.0;
+
+            for (auto frequency : frequencies)
+                value += std::sin (juce::MathConstants<double>::twoPi * frequency * t);
+
+            signal.audio.setSample (0, sample, static_cast<float> (0.05 * value));
+        }
+
+        return signal;
+    }
+
+    // The tools' synthesised guitar (see ToolHelpers::fillTestSignal)
+    TestSignal makeGuitar (double sampleRate, double seconds)
+    {
+        TestSignal signal { "guitar", juce::AudioBuffer<float> (1, static_cast<int> (seconds * sampleRate)) };
+        ToolHelpers::fillTestSignal (signal.audio, sampleRate, true);
+        return signal;
+    }
+
+    // A DI recording, first channel only
+    bool loadFixture (juce::AudioFormatManager& formatManager, const juce::File& file, double sampleRate, TestSignal& signal)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader (formatManager.createReaderFor (file));
+
+        if (reader == nullptr)
+        {
+            std::cerr << "Could not open " << file.getFullPathName() << " as audio\n";
+            return false;
+        }
+
+        if (reader->sampleRate != sampleRate)
+        {
+            std::cerr << file.getFileName() << " is at " << reader->sampleRate << " Hz, not " << sampleRate << " Hz\n";
+            return false;
+        }
+
+        signal.name = file.getFileName();
+        signal.audio.setSize (1, static_cast<int> (reader->lengthInSamples));
+        reader->read (&signal.audio, 0, signal.audio.getNumSamples(), 0, true, false);
+        return true;
+    }
+
+    double getResidualDecibels (const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference)
+    {
+        auto* a = output.getReadPointer (0);
+        auto* b = reference.getReadPointer (0);
+        auto residual = 0.0, energy = 0.0;
+
+        for (int i = 0; i < reference.getNumSamples(); ++i)
+        {
+            residual += juce::square (static_cast<double> (a[i]) - b[i]);
+            energy += juce::square (static_cast<double> (b[i]));
+        }
+
+        return 10.0 * std::log10 (juce::jmax (residual, 1.0e-30) / juce::jmax (energy, 1.0e-30));
+    }
+
+    // Magnitude-spectrum error against the reference over half-overlapping Hann
+    // frames, in dB relative to the reference. Phase differences within a frame
+    // don't count, so minimum-phase filters are not charged for their phase response
+    constexpr int spectralOrder = 12;
+    constexpr int spectralSize = 1 << spectralOrder;
+
+    double getSpectralErrorDecibels (const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference)
+    {
+        juce::dsp::FFT fft (spectralOrder);
+        std::vector<float> window (spectralSize), a (2 * spectralSize), b (2 * spectralSize);
+
+        for (int i = 0; i < spectralSize; ++i)
+            window[static_cast<size_t> (i)] = static_cast<float> (0.5 - 0.5 * std::cos (juce::MathConstants<double>::twoPi * i / spectralSize));
+
+        auto error = 0.0, energy = 0.0;
+
+        for (int start = 0; start + spectralSize <= reference.getNumSamples(); start += spectralSize / 2)
+        {
+            std::fill (a.begin(), a.end(), 0.0f);
+            std::fill (b.begin(), b.end(), 0.0f);
+
+            for (int i = 0; i < spectralSize; ++i)
+            {
+                a[static_cast<size_t> (i)] = output.getSample (0, start + i) * window[static_cast<size_t> (i)];
+                b[static_cast<size_t> (i)] = reference.getSample (0, start + i) * window[static_cast<size_t> (i)];
+            }
+
+            fft.performFrequencyOnlyForwardTransform (a.data(), true);
+            fft.performFrequencyOnlyForwardTransform (b.data(), true);
+
+            for (size_t bin = 0; bin <= spectralSize / 2; ++bin)
+            {
+                error += juce::square (static_cast<double> (a[bin]) - b[bin]);
+                energy += juce::square (static_cast<double> (b[bin]));
+            }
+        }
+
+        return 10.0 * std::log10 (juce::jmax (error, 1.0e-30) / juce::jmax (energy, 1.0e-30));
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    ExplorerSettings settings;
+
+    if (! parseArguments (argc, argv, settings))
+        return 1;
+
+    // Null-test signals: the multitone, then the DI fixtures or the synthesised guitar
+    std::vector<TestSignal> signals;
+    signals.push_back (makeMultitone (settings.sampleRate, settings.signalSeconds));
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    for (auto& file : settings.fixtures)
+    {
+        TestSignal fixture;
+
+        if (! loadFixture (formatManager, file, settings.sampleRate, fixture))
+            return 1;
+
+        signals.push_back (std::move (fixture));
+    }
+
+    if (settings.fixtures.isEmpty())
+        signals.push_back (makeGuitar (settings.sampleRate, settings.signalSeconds));
+
+    auto sweep = makeSteppedSweep (settings.sampleRate);
+
+    // References: cabinet off for configurations without one, full convolution for the rest
+    std::vector<juce::AudioBuffer<float>> references[2];
+
+    for (int i = 0; i < 2; ++i)
+        for (auto& signal : signals)
+            references[i].push_back (render (signal.audio, referenceQuality, i == 0 ? 0 : 2, referenceBlockSize, settings).output);
+
+    juce::Array<juce::var> results;
+
+    for (auto& quality : qualities)
+    {
+        for (auto cabinet : { 0, 1, 2 })
+        {
+            auto* result = new juce::DynamicObject();
+            result->setProperty ("quality", quality.name);
+            result->setProperty ("cabinet", cabinetNames[cabinet]);
+
+            // Distortion: the sweep's output is the same at any block size
+            auto sweepRender = render (sweep.audio, quality, cabinet, referenceBlockSize, settings);
+            result->setProperty ("latencySamples", sweepRender.latencySamples);
+
+            juce::Array<juce::var> tones;
+            auto worstAliasing = -300.0;
+
+            for (int tone = 0; tone < sweep.bins.size(); ++tone)
+            {
+                auto analysis = analyseTone (sweepRender.output.getReadPointer (0, sweep.frameOffsets[tone]),
+                                             sweep.bins[tone], settings.sampleRate);
+
+                auto* toneResult = new juce::DynamicObject();
+                toneResult->setProperty ("frequency", analysis.frequency);
+                toneResult->setProperty ("thdDb", analysis.thdDecibels);
+                toneResult->setProperty ("aliasingDb", analysis.aliasingDecibels);
+                tones.add (juce::var (toneResult));
+
+                worstAliasing = juce::jmax (worstAliasing, analysis.aliasingDecibels);
+            }
+
+            result->setProperty ("tones", tones);
+            result->setProperty ("worstAliasingDb", worstAliasing);
+
+            // Null tests from the first block size, cost from every block size
+            auto* nulls = new juce::DynamicObject();
+            auto* spectralErrors = new juce::DynamicObject();
+            auto worstNull = -300.0, worstSpectralError = -300.0;
+            juce::Array<juce::var> costs;
+
+            for (auto blockSize : settings.blockSizes)
+            {
+                auto nanoseconds = 0.0;
+                auto numSamples = 0.0;
+
+                for (size_t i = 0; i < signals.size(); ++i)
+                {
+                    auto signalRender = render (signals[i].audio, quality, cabinet, blockSize, settings);
+                    nanoseconds += signalRender.nanoseconds;
+                    numSamples += signals[i].audio.getNumSamples();
+
+                    if (blockSize == settings.blockSizes.getFirst())
+                    {
+                        auto& reference = references[cabinet == 0 ? 0 : 1][i];
+                        auto residual = getResidualDecibels (signalRender.output, reference);
+                        auto spectralError = getSpectralErrorDecibels (signalRender.output, reference);
+
+                        nulls->setProperty (signals[i].name, residual);
+                        spectralErrors->setProperty (signals[i].name, spectralError);
+                        worstNull = juce::jmax (worstNull, residual);
+                        worstSpectralError = juce::jmax (worstSpectralError, spectralError);
+                    }
+                }
+
+                auto* cost = new juce::DynamicObject();
+                cost->setProperty ("blockSize", blockSize);
+                cost->setProperty ("nsPerSample", nanoseconds / numSamples);
+                cost->setProperty ("realtimeFactor", numSamples / settings.sampleRate * 1.0e9 / nanoseconds);
+                costs.add (juce::var (cost));
+            }
+
+            auto minimumPhase = hasMinimumPhaseFilters (quality);
+
+            result->setProperty ("nullComparison", minimumPhase ? "magnitude spectrum" : "waveform");
+            result->setProperty ("nullResidualDb", juce::var (nulls));
+            result->setProperty ("worstNullResidualDb", worstNull);
+            result->setProperty ("spectralErrorDb", juce::var (spectralErrors));
+            result->setProperty ("worstSpectralErrorDb", worstSpectralError);
+            result->setProperty ("cost", costs);
+
+            std::cerr << juce::String (quality.name).paddedRight (' ', 15) << "cab:" << juce::String (cabinetNames[cabinet]).paddedRight (' ', 6)
+                      << "aliasing " << juce::String (worstAliasing, 1) << " dBc, "
+                      << (minimumPhase ? "spectral error " + juce::String (worstSpectralError, 1)
+                                       : "null " + juce::String (worstNull, 1)) << " dB, "
+                      << juce::String (static_cast<double> (costs.getFirst()["nsPerSample"]), 1) << " ns/sample\n";
+
+            results.add (juce::var (result));
+        }
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty ("tool", "ClaudeAmpQualityExplorer");
+    report->setProperty ("version", CLAUDEAMP_VERSION);
+    report->setProperty ("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty ("time", juce::Time::getCurrentTime().toISO8601 (true));
+    report->setProperty ("sampleRate", settings.sampleRate);
+    report->setProperty ("drive", settings.drive);
+    report->setProperty ("reference", referenceQuality.name);
+
+    juce::StringArray signalNames;
+
+    for (auto& signal : signals)
+        signalNames.add (signal.name);
+
+    report->setProperty ("signals", signalNames);
+    report->setProperty ("results", results);
+
+    auto json = juce::JSON::toString (juce::var (report));
+
+    if (settings.outputFile == juce::File())
+        std::cout << json << "\n";
+    else if (! settings.outputFile.replaceWithText (json))
+    {
+        std::cerr << "Could not write " << settings.outputFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    return 0;
+}